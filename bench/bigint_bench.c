@@ -0,0 +1,570 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include<sched.h>
+#endif
+
+#include<getopt.h>
+#include<math.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+#include<array.h>
+#include<bigint.h>
+#include<bigint_io.h>
+#include<bigint_mont.h>
+
+#ifndef BIGINT_BENCH_BUILD_TYPE
+#define BIGINT_BENCH_BUILD_TYPE ""
+#endif
+
+// Operands and results for one kernel at one size.
+typedef struct bench_state_s
+{
+    size_t    limbs;
+    uint32_t  factorial;
+    array_t*  array;
+    bigint_t* a;
+    bigint_t* b;
+    bigint_t* c;
+    bigint_t* d;
+} bench_state_t;
+
+typedef struct bench_kernel_s
+{
+    const char* name;
+    bool (*setup)(bench_state_t* state);
+    bool (*run)(bench_state_t* state);
+} bench_kernel_t;
+
+typedef struct bench_options_s
+{
+    const char* kernels;
+    const char* output;
+    bool        json;
+    size_t      min_limbs;
+    size_t      max_limbs;
+    unsigned    warmup;
+    unsigned    repeats;
+    double      budget;
+    double      sample;
+    int         cpu;
+    unsigned    seed;
+} bench_options_t;
+
+typedef struct bench_result_s
+{
+    size_t iterations;
+    size_t repeats;
+    double min;
+    double median;
+    double mean;
+    double stddev;
+} bench_result_t;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static bigint_t* bench_random(size_t limbs)
+{
+    bigint_t* number = bigint_new();
+    if (number == NULL || !bigint_resize(number, limbs)) {
+        return number;
+    }
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint32_t r = (uint32_t) rand() * 2654435761u ^ (uint32_t) rand();
+        array_set(number, i, &r);
+    }
+
+    // Full size, so the leading limb can't be zero.
+    if (limbs > 0) {
+        bigint_setbit(number, limbs * 32 - 1, 1);
+    }
+    return number;
+}
+
+// Kernels. Setup allocates whatever run needs, run does one operation.
+
+static bool bench_setup_array(bench_state_t* state)
+{
+    state->array = ARRAY_NEW(uint32_t);
+    return state->array != NULL;
+}
+
+// From a fresh array every time, so each run pays for the reallocations.
+static bool bench_run_array_grow(bench_state_t* state)
+{
+    array_delete(state->array);
+    state->array = ARRAY_NEW(uint32_t);
+    bool ok = state->array != NULL;
+
+    for (uint32_t i = 0; ok && i < state->limbs; i++) {
+        ok = array_push_back(state->array, &i);
+    }
+    return ok;
+}
+
+// Capacity for every item up front, so push/pop measures just that.
+static bool bench_setup_array_reserved(bench_state_t* state)
+{
+    return bench_setup_array(state)
+        && ARRAY_RESIZE(state->array, state->limbs)
+        && ARRAY_RESIZE(state->array, 0);
+}
+
+static bool bench_run_array_push_pop(bench_state_t* state)
+{
+    bool ok = true;
+
+    for (uint32_t i = 0; ok && i < state->limbs; i++) {
+        ok = array_push_back(state->array, &i);
+    }
+    for (size_t i = 0; ok && i < state->limbs; i++) {
+        void* item = array_pop_back(state->array);
+        ok = item != NULL;
+        free(item);
+    }
+    return ok;
+}
+
+static bool bench_setup_two(bench_state_t* state)
+{
+    state->a = bench_random(state->limbs);
+    state->b = bench_random(state->limbs);
+    state->c = bigint_new();
+    return state->a != NULL && state->b != NULL && state->c != NULL;
+}
+
+static bool bench_run_add(bench_state_t* state)
+{
+    return bigint_add(state->c, state->a, state->b);
+}
+
+static bool bench_run_sub(bench_state_t* state)
+{
+    return bigint_cmp(state->a, state->b) >= 0
+         ? bigint_sub(state->c, state->a, state->b)
+         : bigint_sub(state->c, state->b, state->a);
+}
+
+static bool bench_run_mul(bench_state_t* state)
+{
+    return bigint_mul(state->c, state->a, state->b);
+}
+
+static bool bench_run_sqr(bench_state_t* state)
+{
+    return bigint_mul(state->c, state->a, state->a);
+}
+
+static bool bench_setup_div(bench_state_t* state)
+{
+    // 2n by n limbs, the shape of a modular reduction.
+    state->a = bench_random(2 * state->limbs);
+    state->b = bench_random(state->limbs);
+    state->c = bigint_new();
+    state->d = bigint_new();
+    return state->a != NULL && state->b != NULL && state->c != NULL && state->d != NULL;
+}
+
+static bool bench_run_div(bench_state_t* state)
+{
+    return bigint_divmod(state->c, state->d, state->a, state->b);
+}
+
+static bool bench_setup_one(bench_state_t* state)
+{
+    state->a = bench_random(state->limbs);
+    return state->a != NULL;
+}
+
+static bool bench_run_to_string(bench_state_t* state)
+{
+    char* digits = bigint_to_string(state->a, 10);
+    free(digits);
+    return digits != NULL;
+}
+
+static bool bench_setup_powm(bench_state_t* state)
+{
+    if (!bench_setup_div(state)) {
+        return false;
+    }
+
+    // Odd modulus, so this measures the Montgomery path.
+    bigint_setbit(state->b, 0, 1);
+    return bigint_divmod(NULL, state->a, state->a, state->b)
+        && bigint_copy(state->d, state->b);
+}
+
+static bool bench_run_powm(bench_state_t* state)
+{
+    return bigint_powm(state->c, state->a, state->d, state->b);
+}
+
+static bool bench_setup_factorial(bench_state_t* state)
+{
+    // Smallest k with k! at least limbs * 32 bits long.
+    double bits = 0;
+    uint32_t k  = 1;
+
+    while (bits < (double) state->limbs * 32) {
+        bits += log2((double) ++k);
+    }
+
+    state->factorial = k;
+    state->a         = bigint_new();
+    return state->a != NULL;
+}
+
+static bool bench_run_factorial(bench_state_t* state)
+{
+    bool ok = bigint_set_u32(state->a, 1);
+
+    for (uint32_t i = 2; ok && i <= state->factorial; i++) {
+        ok = bigint_mul_u32(state->a, state->a, i);
+    }
+    return ok;
+}
+
+static const bench_kernel_t bench_kernels[] = {
+    { "array_grow",     bench_setup_array,          bench_run_array_grow     },
+    { "array_push_pop", bench_setup_array_reserved, bench_run_array_push_pop },
+    { "add",            bench_setup_two,            bench_run_add            },
+    { "sub",            bench_setup_two,            bench_run_sub            },
+    { "mul",            bench_setup_two,            bench_run_mul            },
+    { "sqr",            bench_setup_two,            bench_run_sqr            },
+    { "div",            bench_setup_div,            bench_run_div            },
+    { "to_string",      bench_setup_one,            bench_run_to_string      },
+    { "powm",           bench_setup_powm,           bench_run_powm           },
+    { "factorial",      bench_setup_factorial,      bench_run_factorial      },
+};
+
+#define BENCH_KERNELS (sizeof(bench_kernels) / sizeof(bench_kernels[0]))
+
+static void bench_teardown(bench_state_t* state)
+{
+    bigint_t* all[4] = { state->a, state->b, state->c, state->d };
+
+    for (size_t i = 0; i < 4; i++) {
+        if (all[i] != NULL) {
+            bigint_delete(all[i]);
+        }
+    }
+    if (state->array != NULL) {
+        array_delete(state->array);
+    }
+
+    memset(state, 0, sizeof(*state));
+}
+
+// Seconds taken by `iterations` runs, negative on failure.
+static double bench_sample(const bench_kernel_t* kernel, bench_state_t* state, size_t iterations)
+{
+    double start = bench_now();
+
+    for (size_t i = 0; i < iterations; i++) {
+        if (!kernel->run(state)) {
+            return -1;
+        }
+    }
+
+    return bench_now() - start;
+}
+
+static int bench_compare(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Batches enough iterations into each sample to be well above the clock
+// resolution, then takes as many samples as fit the budget, between 3 and
+// options->repeats. Times are per operation, in nanoseconds.
+static bool bench_measure(const bench_kernel_t* kernel, bench_state_t* state, const bench_options_t* options, bench_result_t* result)
+{
+    size_t iterations = 1;
+    double elapsed;
+
+    while ((elapsed = bench_sample(kernel, state, iterations)) >= 0 && elapsed < options->sample) {
+        iterations *= 2;
+    }
+    if (elapsed < 0) {
+        return false;
+    }
+
+    size_t repeats = (size_t) (options->budget / elapsed);
+    repeats = repeats < 3 ? 3 : repeats > options->repeats ? options->repeats : repeats;
+
+    for (unsigned i = 0; i < options->warmup && elapsed < options->budget; i++) {
+        if (bench_sample(kernel, state, iterations) < 0) {
+            return false;
+        }
+    }
+
+    double* samples = malloc(repeats * sizeof(double));
+    if (samples == NULL) {
+        return false;
+    }
+
+    double sum = 0;
+    for (size_t i = 0; i < repeats; i++) {
+        double t = bench_sample(kernel, state, iterations);
+        if (t < 0) {
+            free(samples);
+            return false;
+        }
+        samples[i] = t * 1e9 / (double) iterations;
+        sum       += samples[i];
+    }
+
+    qsort(samples, repeats, sizeof(double), bench_compare);
+
+    double mean     = sum / (double) repeats;
+    double variance = 0;
+    for (size_t i = 0; i < repeats; i++) {
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    }
+
+    result->iterations = iterations;
+    result->repeats    = repeats;
+    result->min        = samples[0];
+    result->median     = repeats % 2 ? samples[repeats / 2] : (samples[repeats / 2 - 1] + samples[repeats / 2]) / 2;
+    result->mean       = mean;
+    result->stddev     = sqrt(variance / (double) (repeats - 1));
+
+    free(samples);
+    return true;
+}
+
+static bool bench_selected(const bench_options_t* options, const char* name)
+{
+    if (options->kernels == NULL) {
+        return true;
+    }
+
+    size_t      length = strlen(name);
+    const char* list   = options->kernels;
+
+    while (*list != '\0') {
+        size_t item = strcspn(list, ",");
+        if (item == length && strncmp(list, name, length) == 0) {
+            return true;
+        }
+        list += item + (list[item] == ',');
+    }
+
+    return false;
+}
+
+static void bench_pin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((size_t) cpu, &set);
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+    }
+#else
+    fprintf(stderr, "CPU pinning is not supported here, ignoring --cpu %d\n", cpu);
+#endif
+}
+
+static void bench_usage(const char* program)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --kernels LIST   Comma separated kernels to run (default: all)\n"
+        "  --min-limbs N    Smallest operand size (default: 1)\n"
+        "  --max-limbs N    Largest operand size (default: 1000000)\n"
+        "  --warmup N       Samples thrown away before measuring (default: 2)\n"
+        "  --repeats N      Most samples per size (default: 15)\n"
+        "  --budget SECS    Time per size, a kernel stops growing once a\n"
+        "                   single sample takes longer (default: 1)\n"
+        "  --sample SECS    Shortest sample, iterations are batched up to it\n"
+        "                   (default: 0.001)\n"
+        "  --cpu N          Pin to this CPU\n"
+        "  --seed N         Seed for the operands (default: 1)\n"
+        "  --json           JSON instead of CSV\n"
+        "  --output FILE    Write there instead of stdout\n"
+        "  --list           List the kernels and exit\n",
+        program);
+}
+
+static bool bench_parse(bench_options_t* options, int argc, char** argv)
+{
+    static const struct option long_options[] = {
+        { "kernels",   required_argument, NULL, 'k' },
+        { "min-limbs", required_argument, NULL, 'm' },
+        { "max-limbs", required_argument, NULL, 'M' },
+        { "warmup",    required_argument, NULL, 'w' },
+        { "repeats",   required_argument, NULL, 'r' },
+        { "budget",    required_argument, NULL, 'b' },
+        { "sample",    required_argument, NULL, 's' },
+        { "cpu",       required_argument, NULL, 'c' },
+        { "seed",      required_argument, NULL, 'S' },
+        { "json",      no_argument,       NULL, 'j' },
+        { "output",    required_argument, NULL, 'o' },
+        { "list",      no_argument,       NULL, 'l' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL,        0,                 NULL, 0   },
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'k': options->kernels   = optarg;                                break;
+            case 'm': options->min_limbs = strtoull(optarg, NULL, 10);            break;
+            case 'M': options->max_limbs = strtoull(optarg, NULL, 10);            break;
+            case 'w': options->warmup    = (unsigned) strtoul(optarg, NULL, 10);  break;
+            case 'r': options->repeats   = (unsigned) strtoul(optarg, NULL, 10);  break;
+            case 'b': options->budget    = strtod(optarg, NULL);                  break;
+            case 's': options->sample    = strtod(optarg, NULL);                  break;
+            case 'c': options->cpu       = (int) strtol(optarg, NULL, 10);        break;
+            case 'S': options->seed      = (unsigned) strtoul(optarg, NULL, 10);  break;
+            case 'j': options->json      = true;                                  break;
+            case 'o': options->output    = optarg;                                break;
+
+            case 'l':
+                for (size_t i = 0; i < BENCH_KERNELS; i++) {
+                    printf("%s\n", bench_kernels[i].name);
+                }
+                exit(EXIT_SUCCESS);
+
+            default:
+                bench_usage(argv[0]);
+                return false;
+        }
+    }
+
+    if (options->repeats < 3) {
+        options->repeats = 3;
+    }
+    if (options->min_limbs == 0) {
+        options->min_limbs = 1;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    bench_options_t options = {
+        .kernels   = NULL,
+        .output    = NULL,
+        .json      = false,
+        .min_limbs = 1,
+        .max_limbs = 1000000,
+        .warmup    = 2,
+        .repeats   = 15,
+        .budget    = 1.0,
+        .sample    = 0.001,
+        .cpu       = -1,
+        .seed      = 1,
+    };
+
+    if (!bench_parse(&options, argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = options.output != NULL ? fopen(options.output, "w") : stdout;
+    if (out == NULL) {
+        perror(options.output);
+        return EXIT_FAILURE;
+    }
+
+    if (options.cpu >= 0) {
+        bench_pin(options.cpu);
+    }
+
+    if (strcmp(BIGINT_BENCH_BUILD_TYPE, "Release") != 0) {
+        fprintf(stderr, "Warning: build type is \"%s\", timings are only meaningful for Release\n", BIGINT_BENCH_BUILD_TYPE);
+    }
+
+    if (options.json) {
+        fprintf(out, "{\n  \"build_type\": \"%s\",\n  \"cpu\": %d,\n  \"warmup\": %u,\n  \"budget\": %g,\n  \"results\": [",
+                BIGINT_BENCH_BUILD_TYPE, options.cpu, options.warmup, options.budget);
+    } else {
+        fprintf(out, "kernel,limbs,iterations,repeats,min_ns,median_ns,mean_ns,stddev_ns\n");
+    }
+
+    bool first = true;
+    bool ok    = true;
+
+    for (size_t k = 0; ok && k < BENCH_KERNELS; k++) {
+        const bench_kernel_t* kernel = &bench_kernels[k];
+
+        if (!bench_selected(&options, kernel->name)) {
+            continue;
+        }
+
+        // Sizes 1, 2, 5, 10, 20, 50, ...
+        for (size_t base = 1; ok && base <= options.max_limbs; base *= 10) {
+            size_t steps[3] = { base, 2 * base, 5 * base };
+            bool   stop     = false;
+
+            for (size_t s = 0; !stop && s < 3; s++) {
+                size_t limbs = steps[s];
+                if (limbs < options.min_limbs || limbs > options.max_limbs) {
+                    continue;
+                }
+
+                bench_state_t  state;
+                bench_result_t result;
+
+                memset(&state, 0, sizeof(state));
+                memset(&result, 0, sizeof(result));
+                state.limbs = limbs;
+                srand(options.seed);
+
+                fprintf(stderr, "%s %zu\n", kernel->name, limbs);
+                ok = kernel->setup(&state) && bench_measure(kernel, &state, &options, &result);
+                bench_teardown(&state);
+
+                if (!ok) {
+                    fprintf(stderr, "%s failed at %zu limbs\n", kernel->name, limbs);
+                    break;
+                }
+
+                if (options.json) {
+                    fprintf(out, "%s\n    {\"kernel\": \"%s\", \"limbs\": %zu, \"iterations\": %zu, \"repeats\": %zu, "
+                            "\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, \"stddev_ns\": %.1f}",
+                            first ? "" : ",", kernel->name, limbs, result.iterations, result.repeats,
+                            result.min, result.median, result.mean, result.stddev);
+                } else {
+                    fprintf(out, "%s,%zu,%zu,%zu,%.1f,%.1f,%.1f,%.1f\n",
+                            kernel->name, limbs, result.iterations, result.repeats,
+                            result.min, result.median, result.mean, result.stddev);
+                }
+                fflush(out);
+                first = false;
+
+                // Bigger sizes would only take longer.
+                stop = result.min * 1e-9 > options.budget;
+            }
+
+            if (stop) {
+                break;
+            }
+        }
+    }
+
+    if (options.json) {
+        fprintf(out, "\n  ]\n}\n");
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
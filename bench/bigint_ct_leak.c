@@ -0,0 +1,447 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include<sched.h>
+#endif
+
+#include<getopt.h>
+#include<math.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include<x86intrin.h>
+#endif
+
+#include<bigint.h>
+#include<bigint_ct.h>
+#include<bigint_mont.h>
+
+// Timing leak test for bigint_ct.h, after dudect (Reparaz, Balasch and
+// Verbauwhede, "Dude, is my code constant time?"). Each check times one call
+// at a time on two classes of inputs, a fixed one and random ones, picked at
+// random for every call. Welch's t-test then compares the two distributions,
+// as measured and with the slowest calls cropped at a few percentiles. A
+// large |t| means the time depends on the values.
+//
+// The control checks run the variable time counterparts, to show that the
+// test can see a leak on this machine at all.
+
+#define LEAK_BATCH 10000
+#define LEAK_CROPS 8
+
+typedef struct leak_state_s
+{
+    size_t        n;
+    bigint_mont_t mont;
+    uint32_t*     r;
+    bigint_t*     result;
+} leak_state_t;
+
+// An input is three vectors of n limbs, a, b and an exponent, then a mask.
+typedef struct leak_check_s
+{
+    const char* name;
+    bool        control;
+    void (*run)(leak_state_t* state, const uint32_t* input);
+} leak_check_t;
+
+typedef struct leak_stats_s
+{
+    double count[2];
+    double mean[2];
+    double m2[2];
+} leak_stats_t;
+
+typedef struct leak_options_s
+{
+    const char* checks;
+    size_t      limbs;
+    size_t      samples;
+    double      threshold;
+    bool        control;
+    int         cpu;
+    unsigned    seed;
+} leak_options_t;
+
+static uint64_t leak_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+static uint32_t leak_random(void)
+{
+    return (uint32_t) rand() * 2654435761u ^ (uint32_t) rand();
+}
+
+// Checks. Operands are below the modulus, whose top limb has its top bit set.
+
+static void leak_run_select(leak_state_t* state, const uint32_t* input)
+{
+    bigint_ct_select(state->r, input[3 * state->n], input, input + state->n, state->n);
+}
+
+static void leak_run_cmp(leak_state_t* state, const uint32_t* input)
+{
+    state->r[0] = (uint32_t) bigint_ct_cmp(input, input + state->n, state->n);
+}
+
+static void leak_run_equals(leak_state_t* state, const uint32_t* input)
+{
+    state->r[0] = bigint_ct_equals(input, input + state->n, state->n);
+}
+
+static void leak_run_addmod(leak_state_t* state, const uint32_t* input)
+{
+    bigint_ct_addmod(&state->mont, state->r, input, input + state->n);
+}
+
+static void leak_run_submod(leak_state_t* state, const uint32_t* input)
+{
+    bigint_ct_submod(&state->mont, state->r, input, input + state->n);
+}
+
+static void leak_run_mulmod(leak_state_t* state, const uint32_t* input)
+{
+    bigint_ct_mulmod(&state->mont, state->r, input, input + state->n);
+}
+
+static void leak_run_powm(leak_state_t* state, const uint32_t* input)
+{
+    bigint_ct_powm(&state->mont, state->r, input, input + 2 * state->n, state->n);
+}
+
+static void leak_run_cmp_vartime(leak_state_t* state, const uint32_t* input)
+{
+    bigint_t a, b;
+    bigint_wrap(&a, input, state->n);
+    bigint_wrap(&b, input + state->n, state->n);
+
+    state->r[0] = (uint32_t) bigint_cmp(&a, &b);
+
+    bigint_release(&a);
+    bigint_release(&b);
+}
+
+static void leak_run_powm_vartime(leak_state_t* state, const uint32_t* input)
+{
+    bigint_t base, exponent;
+    bigint_wrap(&base, input, state->n);
+    bigint_wrap(&exponent, input + 2 * state->n, state->n);
+
+    bigint_mont_powm(&state->mont, state->result, &base, &exponent);
+
+    bigint_release(&base);
+    bigint_release(&exponent);
+}
+
+static const leak_check_t leak_checks[] = {
+    { "select",        false, leak_run_select       },
+    { "cmp",           false, leak_run_cmp          },
+    { "equals",        false, leak_run_equals       },
+    { "addmod",        false, leak_run_addmod       },
+    { "submod",        false, leak_run_submod       },
+    { "mulmod",        false, leak_run_mulmod       },
+    { "powm",          false, leak_run_powm         },
+    { "cmp_vartime",   true,  leak_run_cmp_vartime  },
+    { "powm_vartime",  true,  leak_run_powm_vartime },
+};
+
+#define LEAK_CHECKS (sizeof(leak_checks) / sizeof(leak_checks[0]))
+
+// Class 0 is all zeroes, a mask of zero and a zero exponent. Class 1 is
+// random, with a random mask.
+static void leak_prepare(leak_state_t* state, uint32_t* input, int cls)
+{
+    size_t n = state->n;
+
+    memset(input, 0, (3 * n + 1) * sizeof(uint32_t));
+    if (cls == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < 3 * n; i++) {
+        input[i] = leak_random();
+    }
+    input[0] %= state->mont.modulus[0];
+    input[n] %= state->mont.modulus[0];
+    input[3 * n] = 0u - (leak_random() & 1);
+}
+
+static void leak_add(leak_stats_t* stats, int cls, double x)
+{
+    // Welford's running mean and variance.
+    stats->count[cls] += 1;
+    double delta       = x - stats->mean[cls];
+    stats->mean[cls]  += delta / stats->count[cls];
+    stats->m2[cls]    += delta * (x - stats->mean[cls]);
+}
+
+static double leak_t(const leak_stats_t* stats)
+{
+    if (stats->count[0] < 2 || stats->count[1] < 2) {
+        return 0;
+    }
+
+    double v0 = stats->m2[0] / (stats->count[0] - 1);
+    double v1 = stats->m2[1] / (stats->count[1] - 1);
+    double se = sqrt(v0 / stats->count[0] + v1 / stats->count[1]);
+
+    return se > 0 ? fabs(stats->mean[0] - stats->mean[1]) / se : 0;
+}
+
+static int leak_compare(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+// Largest |t| over the uncropped test and the crops, or -1 when out of memory.
+static double leak_measure(const leak_check_t* check, leak_state_t* state, size_t samples)
+{
+    size_t    stride = 3 * state->n + 1;
+    uint32_t* inputs = malloc(LEAK_BATCH * stride * sizeof(uint32_t));
+    uint64_t* times  = malloc(LEAK_BATCH * sizeof(uint64_t));
+    uint64_t* sorted = malloc(LEAK_BATCH * sizeof(uint64_t));
+    int*      cls    = malloc(LEAK_BATCH * sizeof(int));
+
+    leak_stats_t stats[LEAK_CROPS + 1];
+    uint64_t     crops[LEAK_CROPS];
+    double       worst = -1;
+
+    memset(stats, 0, sizeof(stats));
+
+    // The first batch only warms up and sets the crops.
+    for (size_t done = 0; inputs != NULL && times != NULL && sorted != NULL && cls != NULL && done < samples + LEAK_BATCH; done += LEAK_BATCH) {
+        for (size_t i = 0; i < LEAK_BATCH; i++) {
+            cls[i] = rand() & 1;
+            leak_prepare(state, inputs + i * stride, cls[i]);
+        }
+
+        for (size_t i = 0; i < LEAK_BATCH; i++) {
+            uint64_t start = leak_ticks();
+            check->run(state, inputs + i * stride);
+            times[i] = leak_ticks() - start;
+        }
+
+        if (done == 0) {
+            memcpy(sorted, times, LEAK_BATCH * sizeof(uint64_t));
+            qsort(sorted, LEAK_BATCH, sizeof(uint64_t), leak_compare);
+
+            // Percentiles 1 - 0.5^(10 (k + 1) / crops), bunched up near the top.
+            for (size_t k = 0; k < LEAK_CROPS; k++) {
+                double p = 1 - pow(0.5, 10.0 * (double) (k + 1) / LEAK_CROPS);
+                crops[k] = sorted[(size_t) (p * (LEAK_BATCH - 1))];
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < LEAK_BATCH; i++) {
+            leak_add(&stats[LEAK_CROPS], cls[i], (double) times[i]);
+
+            for (size_t k = 0; k < LEAK_CROPS; k++) {
+                if (times[i] <= crops[k]) {
+                    leak_add(&stats[k], cls[i], (double) times[i]);
+                }
+            }
+        }
+
+        worst = 0;
+        for (size_t k = 0; k <= LEAK_CROPS; k++) {
+            double t = leak_t(&stats[k]);
+            worst = t > worst ? t : worst;
+        }
+    }
+
+    free(inputs);
+    free(times);
+    free(sorted);
+    free(cls);
+    return worst;
+}
+
+static bool leak_selected(const leak_options_t* options, const leak_check_t* check)
+{
+    if (options->checks == NULL) {
+        return !check->control || options->control;
+    }
+
+    size_t      length = strlen(check->name);
+    const char* list   = options->checks;
+
+    while (*list != '\0') {
+        size_t item = strcspn(list, ",");
+        if (item == length && strncmp(list, check->name, length) == 0) {
+            return true;
+        }
+        list += item + (list[item] == ',');
+    }
+
+    return false;
+}
+
+static void leak_pin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((size_t) cpu, &set);
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+    }
+#else
+    fprintf(stderr, "CPU pinning is not supported here, ignoring --cpu %d\n", cpu);
+#endif
+}
+
+static void leak_usage(const char* program)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --checks LIST    Comma separated checks to run (default: all but\n"
+        "                   the controls)\n"
+        "  --control        Run the variable time controls too\n"
+        "  --limbs N        Operand size (default: 8)\n"
+        "  --samples N      Timed calls per check (default: 200000)\n"
+        "  --threshold T    Largest |t| that passes (default: 10)\n"
+        "  --cpu N          Pin to this CPU\n"
+        "  --seed N         Seed for the inputs (default: 1)\n"
+        "  --list           List the checks and exit\n",
+        program);
+}
+
+static bool leak_parse(leak_options_t* options, int argc, char** argv)
+{
+    static const struct option long_options[] = {
+        { "checks",    required_argument, NULL, 'k' },
+        { "control",   no_argument,       NULL, 'C' },
+        { "limbs",     required_argument, NULL, 'n' },
+        { "samples",   required_argument, NULL, 's' },
+        { "threshold", required_argument, NULL, 't' },
+        { "cpu",       required_argument, NULL, 'c' },
+        { "seed",      required_argument, NULL, 'S' },
+        { "list",      no_argument,       NULL, 'l' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL,        0,                 NULL, 0   },
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'k': options->checks    = optarg;                                break;
+            case 'C': options->control   = true;                                  break;
+            case 'n': options->limbs     = strtoull(optarg, NULL, 10);            break;
+            case 's': options->samples   = strtoull(optarg, NULL, 10);            break;
+            case 't': options->threshold = strtod(optarg, NULL);                  break;
+            case 'c': options->cpu       = (int) strtol(optarg, NULL, 10);        break;
+            case 'S': options->seed      = (unsigned) strtoul(optarg, NULL, 10);  break;
+
+            case 'l':
+                for (size_t i = 0; i < LEAK_CHECKS; i++) {
+                    printf("%s%s\n", leak_checks[i].name, leak_checks[i].control ? " (control)" : "");
+                }
+                exit(EXIT_SUCCESS);
+
+            default:
+                leak_usage(argv[0]);
+                return false;
+        }
+    }
+
+    if (options->limbs == 0) {
+        options->limbs = 1;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    leak_options_t options = {
+        .checks    = NULL,
+        .limbs     = 8,
+        .samples   = 200000,
+        .threshold = 10,
+        .control   = false,
+        .cpu       = -1,
+        .seed      = 1,
+    };
+
+    if (!leak_parse(&options, argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (options.cpu >= 0) {
+        leak_pin(options.cpu);
+    }
+
+    srand(options.seed);
+
+    leak_state_t state = { .n = options.limbs };
+    bigint_t*    m     = bigint_new();
+
+    bool ok = m != NULL && bigint_resize(m, state.n);
+    for (size_t i = 0; ok && i < state.n; i++) {
+        uint32_t limb = leak_random();
+        array_set(m, i, &limb);
+    }
+
+    if (ok) {
+        bigint_setbit(m, 32 * state.n - 1, 1);
+        bigint_setbit(m, 0, 1);
+    }
+
+    state.r      = malloc(state.n * sizeof(uint32_t));
+    state.result = bigint_new();
+    ok = ok && state.r != NULL && state.result != NULL && bigint_mont_init(&state.mont, m);
+
+    if (!ok) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("check,limbs,samples,max_t,verdict\n");
+
+    bool leaked = false;
+
+    for (size_t i = 0; i < LEAK_CHECKS; i++) {
+        const leak_check_t* check = &leak_checks[i];
+
+        if (!leak_selected(&options, check)) {
+            continue;
+        }
+
+        double t = leak_measure(check, &state, options.samples);
+        if (t < 0) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+        const char* verdict;
+        if (check->control) {
+            verdict = t > options.threshold ? "leaks, as expected" : "leak not detected";
+        } else {
+            verdict = t > options.threshold ? "LEAKS" : "ok";
+            leaked  = leaked || t > options.threshold;
+        }
+
+        printf("%s,%zu,%zu,%.2f,%s\n", check->name, state.n, options.samples, t, verdict);
+        fflush(stdout);
+    }
+
+    bigint_mont_free(&state.mont);
+    bigint_delete(state.result);
+    bigint_delete(m);
+    free(state.r);
+
+    return leaked ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+#include<getopt.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+#include<bigint.h>
+#include<bigint_gcd.h>
+#include<bigint_io.h>
+#include<bigint_tune.h>
+
+// Finds each threshold by timing the operation at size n with the threshold
+// just above n (the simpler algorithm at the top level) and at n (one level
+// of the other, falling back below it), on growing sizes. The crossover is
+// the first n from which the other algorithm wins a few sizes in a row.
+#define TUNE_CONFIRM 3
+#define TUNE_SAMPLES 5
+#define TUNE_SAMPLE  0.002
+
+typedef struct tune_state_s
+{
+    bigint_t* a;
+    bigint_t* b;
+    bigint_t* c;
+} tune_state_t;
+
+typedef bool (*tune_run_t)(tune_state_t* state);
+
+static double tune_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void tune_random(bigint_t* number, size_t limbs)
+{
+    bigint_set_u32(number, 0);
+    bigint_resize(number, limbs);
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint32_t r = (uint32_t) rand() * 2654435761u ^ (uint32_t) rand();
+        array_set(number, i, &r);
+    }
+    bigint_setbit(number, limbs * 32 - 1, 1);
+}
+
+static bool tune_run_mul(tune_state_t* state)
+{
+    return bigint_mul(state->c, state->a, state->b);
+}
+
+static bool tune_run_sqr(tune_state_t* state)
+{
+    return bigint_mul(state->c, state->a, state->a);
+}
+
+static bool tune_run_gcd(tune_state_t* state)
+{
+    return bigint_gcd(state->c, state->a, state->b);
+}
+
+static bool tune_run_radix(tune_state_t* state)
+{
+    char* digits = bigint_to_string(state->a, 10);
+    free(digits);
+    return digits != NULL;
+}
+
+// Best time per operation over a few samples, each batched to TUNE_SAMPLE.
+static double tune_time(tune_run_t run, tune_state_t* state)
+{
+    size_t iterations = 1;
+    double best       = -1;
+
+    for (int s = 0; s < TUNE_SAMPLES; s++) {
+        double start = tune_now();
+        for (size_t i = 0; i < iterations; i++) {
+            if (!run(state)) {
+                return -1;
+            }
+        }
+        double elapsed = tune_now() - start;
+
+        if (elapsed < TUNE_SAMPLE) {
+            iterations *= 2;
+            s--;
+            continue;
+        }
+
+        double per = elapsed / (double) iterations;
+        best = best < 0 || per < best ? per : best;
+    }
+
+    return best;
+}
+
+static size_t tune_threshold(bigint_threshold_t which, tune_run_t run, size_t from, size_t to)
+{
+    tune_state_t state = { bigint_new(), bigint_new(), bigint_new() };
+    size_t       saved = bigint_threshold_get(which);
+    size_t       found = to;
+    size_t       first = 0;
+    int          wins  = 0;
+
+    fprintf(stderr, "%s\n%8s %12s %12s\n", bigint_threshold_name(which), "limbs", "below ns", "above ns");
+
+    for (size_t n = from; n <= to; n += n / 16 + 1) {
+        tune_random(state.a, n);
+        tune_random(state.b, n);
+
+        bigint_threshold_set(which, n + 1);
+        double below = tune_time(run, &state);
+        bigint_threshold_set(which, n);
+        double above = tune_time(run, &state);
+
+        fprintf(stderr, "%8zu %12.0f %12.0f\n", n, below * 1e9, above * 1e9);
+
+        if (above < below) {
+            first = wins == 0 ? n : first;
+            if (++wins == TUNE_CONFIRM) {
+                found = first;
+                break;
+            }
+        } else {
+            wins = 0;
+        }
+    }
+
+    bigint_threshold_set(which, saved);
+    bigint_delete(state.a);
+    bigint_delete(state.b);
+    bigint_delete(state.c);
+    return found;
+}
+
+int main(int argc, char** argv)
+{
+    static const struct option long_options[] = {
+        { "output", required_argument, NULL, 'o' },
+        { "max",    required_argument, NULL, 'm' },
+        { "help",   no_argument,       NULL, 'h' },
+        { NULL,     0,                 NULL, 0   },
+    };
+
+    const char* output = NULL;
+    size_t      max    = 512;
+    int         c;
+
+    while ((c = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'o': output = optarg;                         break;
+            case 'm': max    = strtoull(optarg, NULL, 10);     break;
+            default:
+                fprintf(stderr,
+                    "Usage: %s [--output FILE] [--max LIMBS]\n"
+                    "Measures the thresholds in bigint_tune.h and writes them as a\n"
+                    "bigint_tuned.h header, to stdout by default.\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    srand(1);
+
+    size_t values[BIGINT_THRESHOLDS];
+    values[BIGINT_THRESHOLD_MUL_KARATSUBA] = tune_threshold(BIGINT_THRESHOLD_MUL_KARATSUBA, tune_run_mul, 5, max);
+    values[BIGINT_THRESHOLD_SQR_KARATSUBA] = tune_threshold(BIGINT_THRESHOLD_SQR_KARATSUBA, tune_run_sqr, 5, max);
+    values[BIGINT_THRESHOLD_RADIX_DC]      = tune_threshold(BIGINT_THRESHOLD_RADIX_DC, tune_run_radix, 2, max);
+
+    // Half-GCD steps only pay off on much longer operands than the others.
+    values[BIGINT_THRESHOLD_GCD_HALF]      = tune_threshold(BIGINT_THRESHOLD_GCD_HALF, tune_run_gcd, max / 2, max * 16);
+
+    FILE* out = output != NULL ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        perror(output);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(out,
+        "// Generated by bigint_tune, run it again rather than editing this.\n"
+        "#ifndef BIGINT_TUNED_H\n"
+        "#define BIGINT_TUNED_H\n"
+        "\n");
+
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        fprintf(out, "#define BIGINT_TUNED_%-13s %zu\n", bigint_threshold_name((bigint_threshold_t) i), values[i]);
+    }
+
+    fprintf(out, "\n#endif // BIGINT_TUNED_H\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include<bigint.h>
+#include<bigint_tune.h>
+
+#include "differential.h"
+
+// Differential fuzzing against tests/reference.c. An input is
+//
+//   op, flags, small, split a, split b, operand bytes...
+//
+// where the low flag bits put each threshold in bigint_tune.h at its smallest
+// (otherwise it stays at the default), the next two pick the aliasing, and
+// the splits cut the remaining bytes into the big endian operands a, b, c.
+//
+// Built with BIGINT_LIBFUZZER this is a libFuzzer target. Otherwise it runs
+// every file named on the command line, or stdin, for AFL and for replaying
+// crashes: afl-fuzz -i seeds -o out -- bigint_fuzz @@
+
+// The reference is quadratic or worse, keep the operands small enough for
+// the fuzzer to stay fast.
+#define FUZZ_MAX_BYTES    1024
+#define FUZZ_POWM_BYTES   64
+#define FUZZ_EXPONENT     8
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static size_t fuzz_defaults[BIGINT_THRESHOLDS];
+
+static bigint_t* fuzz_operand(const uint8_t* bytes, size_t count)
+{
+    bigint_t* number = bigint_new();
+    size_t    limbs  = (count + 3) / 4;
+    size_t    pad    = 4 * limbs - count;
+
+    if (number == NULL || !bigint_resize(number, limbs)) {
+        abort();
+    }
+
+    // Leading zero bytes and limbs are kept, the library has to cope.
+    for (size_t i = 0; i < limbs; i++) {
+        uint32_t limb = 0;
+
+        for (size_t k = 4 * i; k < 4 * i + 4; k++) {
+            limb = limb << 8 | (k >= pad ? bytes[k - pad] : 0);
+        }
+
+        array_set(number, i, &limb);
+    }
+
+    return number;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size < 5) {
+        return 0;
+    }
+
+    if (fuzz_defaults[0] == 0) {
+        for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+            fuzz_defaults[i] = bigint_threshold_get((bigint_threshold_t) i);
+        }
+    }
+
+    differential_op_t op    = (differential_op_t) (data[0] % DIFFERENTIAL_OPS);
+    uint8_t           flags = data[1];
+
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        bigint_threshold_set((bigint_threshold_t) i, flags & (1 << i) ? 0 : fuzz_defaults[i]);
+    }
+
+    const uint8_t* bytes = data + 5;
+    size_t         count = size - 5;
+    size_t         max   = op == DIFFERENTIAL_POWM ? FUZZ_POWM_BYTES : FUZZ_MAX_BYTES;
+
+    count = count > max ? max : count;
+
+    size_t an = count * data[3] / 256;
+    size_t bn = (count - an) * data[4] / 256;
+    size_t cn = count - an - bn;
+
+    if (op == DIFFERENTIAL_POWM && bn > FUZZ_EXPONENT) {
+        bn = FUZZ_EXPONENT;
+    }
+
+    // Small operands: the multiplier or divisor as is, shifts, bases and root
+    // degrees a little past their valid ranges.
+    uint32_t small = data[2];
+    switch (op) {
+        case DIFFERENTIAL_MUL_U32:
+        case DIFFERENTIAL_DIVMOD_U32: small = small * 0x01010101u;       break;
+        case DIFFERENTIAL_TO_STRING:  small = small % 38;                break;
+        case DIFFERENTIAL_ROOT:       small = small % 9;                 break;
+        default:                                                         break;
+    }
+
+    differential_case_t test = {
+        .op    = op,
+        .alias = (differential_alias_t) ((flags >> 4) % DIFFERENTIAL_ALIASES),
+        .a     = fuzz_operand(bytes, an),
+        .b     = fuzz_operand(bytes + an, bn),
+        .c     = fuzz_operand(bytes + an + bn, cn),
+        .small = small,
+    };
+
+    if (!differential_check(&test)) {
+        abort();
+    }
+
+    bigint_delete(test.a);
+    bigint_delete(test.b);
+    bigint_delete(test.c);
+    return 0;
+}
+
+#ifndef BIGINT_LIBFUZZER
+
+static int fuzz_file(FILE* file)
+{
+    size_t   capacity = 4096;
+    size_t   size     = 0;
+    uint8_t* data     = malloc(capacity);
+
+    while (data != NULL) {
+        size += fread(data + size, 1, capacity - size, file);
+        if (size < capacity) {
+            break;
+        }
+
+        uint8_t* bigger = realloc(data, capacity * 2);
+        if (bigger == NULL) {
+            free(data);
+        }
+        data      = bigger;
+        capacity *= 2;
+    }
+
+    if (data == NULL) {
+        perror("bigint_fuzz");
+        return EXIT_FAILURE;
+    }
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        return fuzz_file(stdin);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE* file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            perror(argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        int status = fuzz_file(file);
+        fclose(file);
+
+        if (status != EXIT_SUCCESS) {
+            return status;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+#endif // BIGINT_LIBFUZZER
@@ -1,6 +1,7 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include<stdatomic.h>
 #include<stdbool.h>
 #include<stdint.h>
 #include<stdlib.h>
@@ -17,12 +18,34 @@ typedef struct array_s
     size_t   item_size;
     size_t   size;
     size_t   capacity;
+
+    // Shared buffers (see array_share) carry a reference count, exclusively
+    // owned ones leave this NULL.
+    atomic_size_t* refcount;
+
+    // Items belong to someone else (see array_wrap) and are never written.
+    bool borrowed;
 } array_t;
 
 #define ARRAY_NEW(type) array_new(sizeof(type))
 array_t* array_new(size_t item_size);
 void     array_delete(array_t* array);
 
+// Copy-on-write: array_share returns a new handle over the same items in O(1).
+// Every mutating array_* function unshares first, so handles can be handed to
+// other threads freely. Writes through ARRAY_GET/array_get pointers bypass
+// this, call array_unshare before doing that.
+array_t* array_share(array_t* array);
+bool     array_unshare(array_t* array);
+bool     array_is_shared(array_t* array);
+
+// Turns a caller-owned struct into a read-only view over caller-owned items,
+// nothing is allocated or copied. Writes go through array_unshare like shared
+// buffers do, so the items are never touched. array_release drops whatever
+// the struct holds without freeing the struct itself.
+void     array_wrap(array_t* array, const void* items, size_t item_size, size_t size);
+void     array_release(array_t* array);
+
 #define ARRAY_RESIZE(array, new_size)   array_resize(array, new_size, ARRAY_ALIGN_LEFT)
 #define ARRAY_RESIZE_L(array, new_size) array_resize(array, new_size, ARRAY_ALIGN_LEFT)
 #define ARRAY_RESIZE_R(array, new_size) array_resize(array, new_size, ARRAY_ALIGN_RIGHT)
@@ -0,0 +1,59 @@
+#ifndef BIGINT_ACCUMULATOR_H
+#define BIGINT_ACCUMULATOR_H
+
+#include "bigint.h"
+
+// Sums and products of many values, pushed one at a time, say from a stream:
+//
+//     bigint_accumulator_t acc;
+//     bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_PRODUCT);
+//     while (...) {
+//         bigint_accumulator_push(&acc, value);
+//     }
+//     bigint_accumulator_finish(&acc, result);
+//     bigint_accumulator_free(&acc);
+//
+// Products are kept as a binary counter of partial products, each level
+// about twice the size of the one below, so every multiplication is between
+// operands of similar size. Small values are first multiplied into a leaf
+// of a few limbs. Sums add limbs into 64 bit columns without propagating
+// the carries, which is done once at the end and every 2^32 values.
+//
+// Memory stays within a small multiple of the result for products, and of
+// the largest value pushed for sums.
+typedef enum bigint_accumulator_op_e
+{
+    BIGINT_ACCUMULATE_SUM = 0,
+    BIGINT_ACCUMULATE_PRODUCT,
+} bigint_accumulator_op_t;
+
+typedef struct bigint_accumulator_s
+{
+    bigint_accumulator_op_t op;
+    size_t                  count;   // Values pushed since the last finish
+
+    // Sums: columns of uint64_t, least significant first, and the values
+    // added since the carries were last propagated.
+    array_t*                columns;
+    uint32_t                pending;
+
+    // Products: the leaf, and levels of bigint_t*, NULL when empty.
+    bigint_t*               leaf;
+    array_t*                levels;
+} bigint_accumulator_t;
+
+// False when out of memory.
+bool bigint_accumulator_init(bigint_accumulator_t* acc, bigint_accumulator_op_t op);
+void bigint_accumulator_free(bigint_accumulator_t* acc);
+
+// The value is read, not kept. False when out of memory, nothing pushed so
+// far is lost then and the push can be retried.
+bool bigint_accumulator_push(bigint_accumulator_t* acc, bigint_t* value);
+bool bigint_accumulator_push_u32(bigint_accumulator_t* acc, uint32_t value);
+
+// result = the sum or product of everything pushed, 0 or 1 when nothing
+// was. Empties the accumulator, which can be used again. Left as it was when
+// out of memory.
+bool bigint_accumulator_finish(bigint_accumulator_t* acc, bigint_t* result);
+
+#endif // BIGINT_ACCUMULATOR_H
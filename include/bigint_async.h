@@ -0,0 +1,60 @@
+#ifndef BIGINT_ASYNC_H
+#define BIGINT_ASYNC_H
+
+#include "bigint.h"
+
+// Long multiplications and conversions on a pool of worker threads, so the
+// caller doesn't block on them:
+//
+//     bigint_job_t* job = bigint_mul_async(a, b);
+//     while (bigint_job_poll(job) == BIGINT_JOB_RUNNING) {
+//         ... bigint_job_progress(job) ...
+//     }
+//     bigint_job_result(job, result);
+//     bigint_job_delete(job);
+//
+// Jobs hold their own copy-on-write share of the operands (see bigint_share),
+// the caller may change or delete them right away. Views from bigint_wrap are
+// copied instead, since they may be released.
+//
+// Cancelling is cooperative: a running job stops at the next recursion
+// boundary of the multiplication or conversion, a queued one never starts.
+typedef enum bigint_job_status_e
+{
+    BIGINT_JOB_RUNNING = 0, // Queued or running
+    BIGINT_JOB_DONE,
+    BIGINT_JOB_FAILED,      // Out of memory, or a base out of range
+    BIGINT_JOB_CANCELLED,
+} bigint_job_status_t;
+
+typedef struct bigint_job_s bigint_job_t;
+
+// NULL when out of memory, when no worker could be started or while
+// bigint_async_shutdown is stopping them.
+bigint_job_t*       bigint_mul_async(bigint_t* a, bigint_t* b);
+bigint_job_t*       bigint_to_string_async(bigint_t* number, unsigned base);
+
+bigint_job_status_t bigint_job_poll(bigint_job_t* job);
+bigint_job_status_t bigint_job_wait(bigint_job_t* job);
+void                bigint_job_cancel(bigint_job_t* job);
+
+// From 0 to 1, estimated from the operand sizes. It is 1 once the job is done.
+double              bigint_job_progress(bigint_job_t* job);
+
+// What a finished job computed, handed over once: the product goes into
+// result, the string is the caller's to free. False or NULL for any other
+// kind of job or status.
+bool                bigint_job_result(bigint_job_t* job, bigint_t* result);
+char*               bigint_job_string(bigint_job_t* job);
+
+// Cancels the job if it hasn't finished, and waits for it.
+void                bigint_job_delete(bigint_job_t* job);
+
+// Workers are started with the first job, as many as set here or one per
+// CPU for 0, the default. bigint_async_shutdown lets the queued jobs finish
+// and stops them, refusing new ones meanwhile. The next job after it starts
+// them again.
+void                bigint_async_set_threads(size_t threads);
+void                bigint_async_shutdown(void);
+
+#endif // BIGINT_ASYNC_H
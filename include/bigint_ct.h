@@ -0,0 +1,48 @@
+#ifndef BIGINT_CT_H
+#define BIGINT_CT_H
+
+#include "bigint.h"
+#include "bigint_mont.h"
+
+// Constant time arithmetic, for secret operands. Numbers are fixed width
+// vectors of n limbs, most significant first as in bigint_t, with as many
+// leading zero limbs as it takes. What these do, how long they take and
+// which memory they touch depend on the sizes only, never on the values.
+// Sizes and moduli are public.
+//
+// Conditions are masks: all ones for true, zero for false.
+
+// Copies a into n limbs, false when it doesn't fit. Only a's stored size
+// shows, so keep secrets in bigint_t's of a fixed size too.
+bool     bigint_ct_import(uint32_t* r, size_t n, bigint_t* a);
+
+// result = a[n], keeping the leading zero limbs.
+bool     bigint_ct_export(bigint_t* result, const uint32_t* a, size_t n);
+
+uint32_t bigint_ct_is_zero(const uint32_t* a, size_t n);
+uint32_t bigint_ct_equals(const uint32_t* a, const uint32_t* b, size_t n);
+uint32_t bigint_ct_less(const uint32_t* a, const uint32_t* b, size_t n);
+int      bigint_ct_cmp(const uint32_t* a, const uint32_t* b, size_t n);
+
+// r = mask ? a : b, and both swapped when mask is set. r may be a or b.
+void     bigint_ct_select(uint32_t* r, uint32_t mask, const uint32_t* a, const uint32_t* b, size_t n);
+void     bigint_ct_swap(uint32_t mask, uint32_t* a, uint32_t* b, size_t n);
+
+// r = a + b and a - b, returning the carry or the borrow. r may be a or b.
+uint32_t bigint_ct_add(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+uint32_t bigint_ct_sub(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+
+// Modulo an odd modulus set up with bigint_mont_init, for operands of
+// mont->size limbs below it. r may be any of them. The modular functions
+// take their temporaries from the scratch stack, so they return false when
+// out of memory.
+bool     bigint_ct_addmod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b);
+bool     bigint_ct_submod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b);
+bool     bigint_ct_mulmod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b);
+
+// base^exponent mod m with a Montgomery ladder, a squaring and a
+// multiplication for every one of the 32 en exponent bits, leading zeroes
+// included.
+bool     bigint_ct_powm(bigint_mont_t* mont, uint32_t* r, const uint32_t* base, const uint32_t* exponent, size_t en);
+
+#endif // BIGINT_CT_H
@@ -0,0 +1,79 @@
+#ifndef BIGINT_EXPR_H
+#define BIGINT_EXPR_H
+
+#include "bigint.h"
+
+// Deferred evaluation of sums and products, without a bigint_t per
+// subexpression. Nodes are recorded first and evaluated together:
+//
+//     bigint_expr_t e;
+//     bigint_expr_init(&e);
+//     bigint_expr_node_t ab = bigint_expr_mul(&e, bigint_expr_leaf(&e, a), bigint_expr_leaf(&e, b));
+//     bigint_expr_node_t cd = bigint_expr_mul(&e, bigint_expr_leaf(&e, c), bigint_expr_leaf(&e, d));
+//     bigint_expr_eval(&e, r, bigint_expr_sub(&e, bigint_expr_add(&e, ab, cd), bigint_expr_leaf(&e, x)));
+//     bigint_expr_free(&e);
+//
+// Sums are flattened into one accumulator and products in them are added or
+// subtracted straight into it, single limb factors with addmul/submul. Nodes
+// used more than once are evaluated once. Intermediate values may go below
+// zero, the result can't. Everything runs in one frame of the scratch stack
+// in bigint_scratch.h, and the result is written once.
+typedef size_t bigint_expr_node_t;
+
+// Returned instead of a node when out of memory or given one, so calls nest
+// and only bigint_expr_eval has to be checked.
+#define BIGINT_EXPR_NONE ((bigint_expr_node_t) -1)
+
+typedef enum bigint_expr_op_e
+{
+    BIGINT_EXPR_LEAF = 0,
+    BIGINT_EXPR_U32,
+    BIGINT_EXPR_ADD,
+    BIGINT_EXPR_SUB,
+    BIGINT_EXPR_MUL,
+} bigint_expr_op_t;
+
+typedef struct bigint_expr_item_s
+{
+    bigint_expr_op_t   op;
+    bigint_t*          leaf;
+    uint32_t           value;
+    bigint_expr_node_t left;
+    bigint_expr_node_t right;
+
+    // Filled in by bigint_expr_eval.
+    size_t             bound; // Limbs the magnitude fits in
+    size_t             uses;
+    const uint32_t*    limbs; // Value of a node used more than once
+    size_t             size;
+    bool               negative;
+} bigint_expr_item_t;
+
+typedef struct bigint_expr_s
+{
+    bigint_expr_item_t* items;
+    size_t              count;
+    size_t              capacity;
+    uint32_t*           scratch; // While evaluating
+} bigint_expr_t;
+
+void bigint_expr_init(bigint_expr_t* expr);
+void bigint_expr_free(bigint_expr_t* expr);
+
+// Forgets the nodes but keeps the memory, to build the next expression.
+void bigint_expr_clear(bigint_expr_t* expr);
+
+// Leaves are read when evaluating, not copied, so they have to live until
+// then. The result may be one of them.
+bigint_expr_node_t bigint_expr_leaf(bigint_expr_t* expr, bigint_t* number);
+bigint_expr_node_t bigint_expr_u32(bigint_expr_t* expr, uint32_t value);
+bigint_expr_node_t bigint_expr_add(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b);
+bigint_expr_node_t bigint_expr_sub(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b);
+bigint_expr_node_t bigint_expr_mul(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b);
+
+// False when out of memory, for BIGINT_EXPR_NONE and when the value is
+// negative. The nodes stay, so the same expression can be evaluated again
+// after its leaves change.
+bool bigint_expr_eval(bigint_expr_t* expr, bigint_t* result, bigint_expr_node_t root);
+
+#endif // BIGINT_EXPR_H
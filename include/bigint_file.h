@@ -0,0 +1,56 @@
+#ifndef BIGINT_FILE_H
+#define BIGINT_FILE_H
+
+#include "bigint.h"
+
+// Binary checkpoint format: a fixed header followed by the raw limbs, most
+// significant first, in the byte order of the machine that wrote them. The
+// header is a multiple of 8 bytes, so the limbs of a mapped file are aligned.
+#define BIGINT_FILE_MAGIC   "BIGINT\r\n"
+#define BIGINT_FILE_VERSION 1
+
+typedef struct bigint_file_header_s
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order; // 0x01020304 as stored by the writer
+    uint32_t limb_bits;
+    uint32_t limb_order; // 1 for most significant first
+    uint64_t count;      // Number of limbs
+    uint64_t checksum;   // FNV-1a over the limbs
+} bigint_file_header_t;
+
+// Streaming writer, limbs are appended most significant first and the header
+// is patched on close. The fd must be seekable.
+typedef struct bigint_writer_s
+{
+    int      fd;
+    uint64_t count;
+    uint64_t checksum;
+} bigint_writer_t;
+
+bool bigint_writer_open(bigint_writer_t* writer, int fd);
+bool bigint_writer_append(bigint_writer_t* writer, const uint32_t* limbs, size_t count);
+bool bigint_writer_close(bigint_writer_t* writer);
+
+bool bigint_file_save(const char* path, bigint_t* number);
+
+// Maps a file written on a machine with the same byte order and exposes it as
+// a read-only bigint in map->number, without copying. Writing to it copies
+// first, as with bigint_wrap. `verify` checks the limbs against the checksum,
+// which touches every page.
+typedef struct bigint_map_s
+{
+    bigint_t number;
+    void*    base;
+    size_t   length;
+} bigint_map_t;
+
+bool bigint_file_map(bigint_map_t* map, const char* path, bool verify);
+void bigint_file_unmap(bigint_map_t* map);
+
+// Reads the file into `number`, converting from a foreign byte order if needed.
+// A file that fails the checks leaves `number` as it was.
+bool bigint_file_load(bigint_t* number, const char* path);
+
+#endif // BIGINT_FILE_H
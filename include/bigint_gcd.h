@@ -0,0 +1,15 @@
+#ifndef BIGINT_GCD_H
+#define BIGINT_GCD_H
+
+#include "bigint.h"
+
+bool bigint_gcd(bigint_t* g, bigint_t* a, bigint_t* b);
+
+// g = gcd(a, b) and the cofactor s, with a * s = g (mod b) and 0 <= s < b / g.
+// Numbers are unsigned, so the cofactor of b isn't given. s may be NULL.
+bool bigint_gcdext(bigint_t* g, bigint_t* s, bigint_t* a, bigint_t* b);
+
+// Inverse of a modulo m, false when there is none.
+bool bigint_invert(bigint_t* result, bigint_t* a, bigint_t* m);
+
+#endif // BIGINT_GCD_H
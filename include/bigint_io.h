@@ -0,0 +1,18 @@
+#ifndef BIGINT_IO_H
+#define BIGINT_IO_H
+
+#include<stdio.h>
+
+#include "bigint.h"
+
+// Writes number in any base from 2 to 36, using uppercase letters past 9.
+// Digits are produced most significant first by a divide and conquer
+// conversion and go out through a fixed size buffer, so the memory used on
+// top of the number is proportional to its limbs, not to its digits.
+bool  bigint_write(FILE* stream, bigint_t* number, unsigned base);
+bool  bigint_write_fd(int fd, bigint_t* number, unsigned base);
+
+// Same digits as a NUL terminated string, to be freed by the caller.
+char* bigint_to_string(bigint_t* number, unsigned base);
+
+#endif // BIGINT_IO_H
@@ -0,0 +1,38 @@
+#ifndef BIGINT_MONT_H
+#define BIGINT_MONT_H
+
+#include "bigint.h"
+
+// Montgomery arithmetic modulo an odd number m of n limbs, with R = 2^(32 n).
+// Numbers in Montgomery form stand for x R mod m, so products reduce with
+// shifts by whole limbs instead of divisions.
+typedef struct bigint_mont_s
+{
+    uint32_t* modulus; // n limbs, most significant first
+    uint32_t* one;     // R mod m
+    uint32_t* r2;      // R^2 mod m
+    uint32_t* scratch;
+    size_t    size;    // n
+    uint32_t  inverse; // -1 / m mod 2^32
+} bigint_mont_t;
+
+// False when the modulus is even or when out of memory.
+bool bigint_mont_init(bigint_mont_t* mont, bigint_t* modulus);
+void bigint_mont_free(bigint_mont_t* mont);
+
+// Conversions in and out of Montgomery form. bigint_mont_to reduces its
+// operand first, the others expect them below the modulus.
+bool bigint_mont_to(bigint_mont_t* mont, bigint_t* result, bigint_t* a);
+bool bigint_mont_from(bigint_mont_t* mont, bigint_t* result, bigint_t* a);
+
+// a * b / R mod m, so the product of two numbers in Montgomery form.
+bool bigint_mont_mul(bigint_mont_t* mont, bigint_t* result, bigint_t* a, bigint_t* b);
+
+// base^exponent mod m, with base and result in normal form.
+bool bigint_mont_powm(bigint_mont_t* mont, bigint_t* result, bigint_t* base, bigint_t* exponent);
+
+// base^exponent mod modulus, for any modulus but zero. Odd moduli go through
+// Montgomery multiplication.
+bool bigint_powm(bigint_t* result, bigint_t* base, bigint_t* exponent, bigint_t* modulus);
+
+#endif // BIGINT_MONT_H
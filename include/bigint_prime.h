@@ -0,0 +1,17 @@
+#ifndef BIGINT_PRIME_H
+#define BIGINT_PRIME_H
+
+#include "bigint.h"
+
+// Trial division by the primes below 2048, which settles everything below
+// 2048^2, then the Baillie-PSW test: a strong base 2 Miller-Rabin test and a
+// strong Lucas test. No composite is known to pass it. `reps` adds that many
+// Miller-Rabin rounds on top, with bases 3, 5, 7 and so on. Also false when
+// out of memory.
+bool bigint_is_probab_prime(bigint_t* n, uint32_t reps);
+
+// Smallest probable prime above n. Candidates are sieved by the small primes a
+// window at a time, so only the survivors get the full test.
+bool bigint_next_prime(bigint_t* result, bigint_t* n);
+
+#endif // BIGINT_PRIME_H
@@ -0,0 +1,17 @@
+#ifndef BIGINT_ROOT_H
+#define BIGINT_ROOT_H
+
+#include "bigint.h"
+
+// Integer roots, rounded down. The remainder of bigint_sqrtrem is
+// a - root * root, and either output may be NULL.
+bool bigint_sqrt(bigint_t* root, bigint_t* a);
+bool bigint_sqrtrem(bigint_t* root, bigint_t* remainder, bigint_t* a);
+bool bigint_root(bigint_t* root, bigint_t* a, uint32_t n);
+
+// Predicates, also false when running out of memory. 0 and 1 count as perfect
+// powers, like in GMP.
+bool bigint_is_square(bigint_t* a);
+bool bigint_is_perfect_power(bigint_t* a);
+
+#endif // BIGINT_ROOT_H
@@ -0,0 +1,25 @@
+#ifndef BIGINT_SCRATCH_H
+#define BIGINT_SCRATCH_H
+
+#include<stdbool.h>
+#include<stddef.h>
+
+// Temporaries of multiplication, division, modular powers and radix
+// conversion come from a stack of limbs kept per thread. A top level call
+// works out everything it will need from its operand sizes and grows the
+// stack at most once, later calls of the same size don't allocate. The stack
+// is freed when its thread exits.
+
+// Most bytes any thread has had in use at once since the last reset,
+// counting what didn't fit in its stack and was allocated on the side.
+size_t bigint_scratch_high_water(void);
+void   bigint_scratch_reset_high_water(void);
+
+// Bytes held by the calling thread's stack. Reserving ahead, say the high
+// water mark of a test run, keeps the first calls from allocating. Neither
+// may be called from inside a bigint_* call, from a tracing hook say.
+size_t bigint_scratch_capacity(void);
+bool   bigint_scratch_reserve(size_t bytes);
+void   bigint_scratch_release(void);
+
+#endif // BIGINT_SCRATCH_H
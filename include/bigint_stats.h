@@ -0,0 +1,82 @@
+#ifndef BIGINT_STATS_H
+#define BIGINT_STATS_H
+
+#include<stdbool.h>
+#include<stdint.h>
+
+// Operation counters, only collected when the library is built with the
+// BIGINT_STATS CMake option. Otherwise the counting compiles to nothing and
+// everything here reads as zero.
+//
+// Each thread counts into its own block, reads add up every thread's block
+// plus whatever threads that exited left behind.
+typedef enum bigint_stat_e
+{
+    // Operations, units are limbs of the operands. The timed ones leave out
+    // allocating the result.
+    BIGINT_STAT_ADD = 0,
+    BIGINT_STAT_SUB,
+    BIGINT_STAT_SHIFT,
+    BIGINT_STAT_MUL,         // Timed
+    BIGINT_STAT_DIVMOD,      // Timed
+    BIGINT_STAT_POWM,        // Timed
+    BIGINT_STAT_GCD,         // Timed, beyond two limbs
+    BIGINT_STAT_ROOT,        // Timed, once per precision doubling
+    BIGINT_STAT_RADIX,       // Timed, bases other than powers of two
+
+    // Algorithm picked at each level, units are limbs.
+    BIGINT_STAT_MUL_BASECASE,
+    BIGINT_STAT_MUL_KARATSUBA,
+    BIGINT_STAT_SQR_BASECASE,
+    BIGINT_STAT_SQR_KARATSUBA,
+    BIGINT_STAT_DIV_1,
+    BIGINT_STAT_DIV_KNUTH,
+    BIGINT_STAT_POWM_MONT,
+    BIGINT_STAT_POWM_PLAIN,
+    BIGINT_STAT_GCD_BINARY,
+    BIGINT_STAT_GCD_EUCLID,
+    BIGINT_STAT_GCD_LEHMER,
+    BIGINT_STAT_GCD_HALF,
+    BIGINT_STAT_RADIX_BASECASE,
+    BIGINT_STAT_RADIX_DC,
+
+    // Item buffers in array.c and the scratch stack, units are bytes.
+    BIGINT_STAT_ALLOC,
+    BIGINT_STAT_FREE,
+    BIGINT_STAT_RESIZE_REALLOC, // Moved to a bigger buffer, bytes copied
+    BIGINT_STAT_RESIZE_INPLACE, // Fit the capacity, bytes memmoved
+    BIGINT_STAT_UNSHARE_COPY,   // Copy-on-write copies
+
+    BIGINT_STATS,
+} bigint_stat_t;
+
+typedef struct bigint_stat_value_s
+{
+    uint64_t calls;
+    uint64_t units;
+    uint64_t nanoseconds; // Timed operations only
+} bigint_stat_value_t;
+
+bool        bigint_stats_enabled(void);
+const char* bigint_stat_name(bigint_stat_t stat); // "MUL_KARATSUBA"
+
+// values has BIGINT_STATS entries. Counts from threads still running may be
+// a little behind, and a reset may miss increments racing with it.
+void        bigint_stats_read(bigint_stat_value_t* values);
+void        bigint_stats_reset(void);
+
+// Tracing hook, called on the counting thread for every count and on both
+// ends of every timed operation, with the same units as the counters. Set it
+// while no other thread is counting. NULL removes it.
+typedef enum bigint_trace_e
+{
+    BIGINT_TRACE_COUNT = 0,
+    BIGINT_TRACE_BEGIN,
+    BIGINT_TRACE_END,
+} bigint_trace_t;
+
+typedef void (*bigint_stats_hook_t)(bigint_stat_t stat, bigint_trace_t event, uint64_t units, void* data);
+
+void        bigint_stats_set_hook(bigint_stats_hook_t hook, void* data);
+
+#endif // BIGINT_STATS_H
@@ -0,0 +1,26 @@
+#ifndef BIGINT_TUNE_H
+#define BIGINT_TUNE_H
+
+#include<stddef.h>
+
+// Operand sizes, in limbs, from which the library switches to the algorithm
+// for bigger numbers. Defaults come from the bigint_tuned.h generated by the
+// bigint_tune target, and each can be overridden at startup with an
+// environment variable named after it, e.g. BIGINT_MUL_KARATSUBA_THRESHOLD=40.
+typedef enum bigint_threshold_e
+{
+    BIGINT_THRESHOLD_MUL_KARATSUBA = 0, // Schoolbook to Karatsuba
+    BIGINT_THRESHOLD_SQR_KARATSUBA,     // Same for squaring
+    BIGINT_THRESHOLD_RADIX_DC,          // Chunk by chunk to divide and conquer
+    BIGINT_THRESHOLD_GCD_HALF,          // Lehmer to half-GCD steps
+    BIGINT_THRESHOLDS,
+} bigint_threshold_t;
+
+size_t      bigint_threshold_get(bigint_threshold_t which);
+const char* bigint_threshold_name(bigint_threshold_t which); // "MUL_KARATSUBA"
+
+// Values below what the algorithm supports are raised to that minimum.
+// Meant for tuning, not for changing while other threads compute.
+void        bigint_threshold_set(bigint_threshold_t which, size_t value);
+
+#endif // BIGINT_TUNE_H
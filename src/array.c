@@ -1,4 +1,5 @@
 #include "array.h"
+#include "stats.h"
 
 #include<stdio.h>
 #include<string.h>
@@ -17,18 +18,122 @@ array_t* array_new(size_t item_size)
     new_array->item_size = item_size;
     new_array->size      = 0;
     new_array->capacity  = 0;
+    new_array->refcount  = NULL;
+    new_array->borrowed  = false;
 
     return new_array;
 }
 
-void array_delete(array_t* array)
+// Drops this handle's claim on its items, freeing them if it was the last one.
+static void array_release_items(array_t* array)
 {
-    if (array->items != 0) {
+    if (array->refcount != NULL) {
+        if (atomic_fetch_sub(array->refcount, 1) != 1) {
+            return;
+        }
+        free(array->refcount);
+    }
+
+    if (array->items != NULL && !array->borrowed) {
+        BIGINT_COUNT(BIGINT_STAT_FREE, array->capacity * array->item_size);
         free(array->items);
     }
+}
+
+void array_delete(array_t* array)
+{
+    array_release_items(array);
     free(array);
 }
 
+void array_wrap(array_t* array, const void* items, size_t item_size, size_t size)
+{
+    // Never written through, array_unshare copies before any change.
+    array->items     = (uint8_t*) items;
+    array->item_size = item_size;
+    array->size      = size;
+    array->capacity  = size;
+    array->refcount  = NULL;
+    array->borrowed  = true;
+}
+
+void array_release(array_t* array)
+{
+    array_release_items(array);
+
+    array->items    = NULL;
+    array->size     = 0;
+    array->capacity = 0;
+    array->refcount = NULL;
+    array->borrowed = false;
+}
+
+array_t* array_share(array_t* array)
+{
+    array_t* copy = malloc(sizeof(array_t));
+
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    // First share, the buffer was exclusively ours until now.
+    if (array->refcount == NULL) {
+        array->refcount = malloc(sizeof(atomic_size_t));
+
+        if (array->refcount == NULL) {
+            free(copy);
+            return NULL;
+        }
+
+        atomic_init(array->refcount, 1);
+    }
+
+    atomic_fetch_add(array->refcount, 1);
+    *copy = *array;
+    return copy;
+}
+
+bool array_unshare(array_t* array)
+{
+    if (array->refcount == NULL && !array->borrowed) {
+        return true;
+    }
+
+    // Everybody else let go already, no need to copy.
+    if (!array->borrowed && atomic_load(array->refcount) == 1) {
+        free(array->refcount);
+        array->refcount = NULL;
+        return true;
+    }
+
+    size_t   u8_size   = array->size * array->item_size;
+    uint8_t* new_items = NULL;
+
+    if (u8_size > 0) {
+        new_items = malloc(u8_size);
+        if (new_items == NULL) {
+            return false;
+        }
+        memcpy(new_items, array->items, u8_size);
+
+        BIGINT_COUNT(BIGINT_STAT_ALLOC, u8_size);
+        BIGINT_COUNT(BIGINT_STAT_UNSHARE_COPY, u8_size);
+    }
+
+    array_release_items(array);
+
+    array->items    = new_items;
+    array->capacity = array->size;
+    array->refcount = NULL;
+    array->borrowed = false;
+    return true;
+}
+
+bool array_is_shared(array_t* array)
+{
+    return array->borrowed || (array->refcount != NULL && atomic_load(array->refcount) > 1);
+}
+
 bool array_resize(array_t* array, size_t new_size, array_align_t align)
 {
     // Nothing to do.
@@ -36,13 +141,18 @@ bool array_resize(array_t* array, size_t new_size, array_align_t align)
         return true;
     }
 
+    if (!array_unshare(array)) {
+        return false;
+    }
+
     size_t u8_new_size = new_size    * array->item_size;
     size_t u8_old_size = array->size * array->item_size;
 
     if (new_size < array->size) {
         if (align == ARRAY_ALIGN_RIGHT) {
-            memmove(ARRAY_GET(array, 0), ARRAY_GET_R(array, -1), u8_new_size);
+            memmove(ARRAY_GET(array, 0), ARRAY_GET(array, array->size - new_size), u8_new_size);
         }
+        BIGINT_COUNT(BIGINT_STAT_RESIZE_INPLACE, align == ARRAY_ALIGN_RIGHT ? u8_new_size : 0);
         array->size = new_size;
         return true;
     }
@@ -50,7 +160,7 @@ bool array_resize(array_t* array, size_t new_size, array_align_t align)
     size_t size_diff    = new_size - array->size;
     size_t u8_size_diff = size_diff * array->item_size;
 
-    if (new_size < array->capacity) {
+    if (new_size <= array->capacity) {
 
         if (align == ARRAY_ALIGN_LEFT) {
             memset(ARRAY_GET_R(array, -1), 0, u8_size_diff);
@@ -59,11 +169,12 @@ bool array_resize(array_t* array, size_t new_size, array_align_t align)
             memmove(
                 ARRAY_GET(array, size_diff),  // DST is the ptr STARTING at diff.
                 ARRAY_GET(array, 0),
-                u8_new_size
+                u8_old_size
             );
             memset(ARRAY_GET(array, 0), 0, u8_size_diff);
         }
 
+        BIGINT_COUNT(BIGINT_STAT_RESIZE_INPLACE, align == ARRAY_ALIGN_RIGHT ? u8_old_size : 0);
         array->size = new_size;
         return true;
     }
@@ -73,18 +184,24 @@ bool array_resize(array_t* array, size_t new_size, array_align_t align)
         return false;
     }
 
-    memset(new_items, 0, u8_size_diff);
+    BIGINT_COUNT(BIGINT_STAT_ALLOC, u8_new_size);
+    BIGINT_COUNT(BIGINT_STAT_RESIZE_REALLOC, u8_old_size);
 
     if (align == ARRAY_ALIGN_LEFT) {
-        memmove(new_items, ARRAY_GET(array, 0), u8_old_size);
+        if (u8_old_size > 0) {
+            memmove(new_items, ARRAY_GET(array, 0), u8_old_size);
+        }
+        memset(new_items + u8_old_size, 0, u8_size_diff);
 
     } else {
-        memmove(new_items + u8_size_diff, ARRAY_GET(array, 0), u8_new_size);
+        memset(new_items, 0, u8_size_diff);
+        if (u8_old_size > 0) {
+            memmove(new_items + u8_size_diff, ARRAY_GET(array, 0), u8_old_size);
+        }
     }
 
-    array->size = new_size;
-
     if (array->items != NULL) {
+        BIGINT_COUNT(BIGINT_STAT_FREE, array->capacity * array->item_size);
         free(array->items);
     }
 
@@ -96,7 +213,7 @@ bool array_resize(array_t* array, size_t new_size, array_align_t align)
 
 bool array_set(array_t* array, size_t index, void* value)
 {
-    if (index >= array->size) {
+    if (index >= array->size || !array_unshare(array)) {
         return false;
     }
 
@@ -182,6 +299,11 @@ void* array_pop_front(array_t* array)
     
     size_t new_size = array->size - 1;
 
+    if (!array_unshare(array)) {
+        free(item);
+        return NULL;
+    }
+
     // Shift the array to the left
     memmove(
         array_get(array, 0),        // dst: arrays[0]
@@ -0,0 +1,597 @@
+#include "bigint.h"
+#include "limb.h"
+#include "scratch.h"
+#include "stats.h"
+
+#include<string.h>
+
+bigint_t* bigint_new(void)
+{
+    return ARRAY_NEW(uint32_t);
+}
+
+void bigint_delete(bigint_t* number)
+{
+    array_delete(number);
+}
+
+bool bigint_resize(bigint_t* number, size_t new_size)
+{
+    if (new_size <= number->size) {
+        return true;
+    }
+
+    // Grows on the left, so the new (most significant) limbs are zeroes.
+    return ARRAY_RESIZE_R(number, new_size);
+}
+
+bool bigint_equals(bigint_t* a, bigint_t* b)
+{
+    return bigint_cmp(a, b) == 0;
+}
+
+bigint_t* bigint_share(bigint_t* number)
+{
+    return array_share(number);
+}
+
+bool bigint_unshare(bigint_t* number)
+{
+    return array_unshare(number);
+}
+
+uint32_t bigint_getbit(bigint_t *number, size_t bitnum)
+{
+    return bigint_limb(number, bitnum / 32) & (1u << (bitnum % 32));
+}
+
+void bigint_setbit(bigint_t *number, size_t bitnum, uint32_t value)
+{
+    if (bitnum / 32 >= number->size) {
+        bigint_resize(number, bitnum / 32 + 1);
+    }
+
+    if (!bigint_unshare(number)) {
+        return;
+    }
+
+    value = value != 0 ? 0xFFFFFFFF : 0x00000000;
+    value = value & (1u << (bitnum % 32));
+
+    uint32_t* item = array_get(number, number->size - (bitnum / 32) - 1);
+    *item |= value;
+}
+
+void bigint_wrap(bigint_t* view, const uint32_t* limbs, size_t count)
+{
+    array_wrap(view, limbs, sizeof(uint32_t), count);
+}
+
+void bigint_release(bigint_t* number)
+{
+    array_release(number);
+}
+
+const uint32_t* bigint_limbs(bigint_t* number, size_t* count)
+{
+    const uint32_t* limbs = (const uint32_t*) number->items;
+    size_t          skip  = 0;
+
+    while (skip < number->size && limbs[skip] == 0) {
+        skip++;
+    }
+
+    *count = number->size - skip;
+    return limbs + skip;
+}
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BIGINT_NATIVE_ENDIAN 1
+#else
+#define BIGINT_NATIVE_ENDIAN -1
+#endif
+
+bool bigint_import(bigint_t* number, size_t count, int order, size_t size, int endian, size_t nails, const void* src)
+{
+    const uint8_t* bytes = src;
+    size_t word_bits     = size * 8 - nails;
+    size_t total_limbs   = (count * word_bits + 31) / 32;
+
+    if (endian == 0) {
+        endian = BIGINT_NATIVE_ENDIAN;
+    }
+
+    if (!ARRAY_RESIZE_R(number, total_limbs) || !bigint_unshare(number)) {
+        return false;
+    }
+
+    uint32_t* limbs = (uint32_t*) number->items;
+
+    // Same layout as ours, a single copy does it.
+    if (size == sizeof(uint32_t) && nails == 0 && order == 1 && endian == BIGINT_NATIVE_ENDIAN) {
+        if (total_limbs > 0) {
+            memcpy(limbs, src, total_limbs * sizeof(uint32_t));
+        }
+        return true;
+    }
+
+    uint64_t acc      = 0;
+    size_t   acc_bits = 0;
+    size_t   limb     = 0;
+
+    // Walks the words from least to most significant, and the bytes inside
+    // each word the same way, filling our limbs from the right.
+    for (size_t w = 0; w < count; w++) {
+        const uint8_t* word = bytes + (order == 1 ? count - w - 1 : w) * size;
+        size_t         left = word_bits;
+
+        for (size_t b = 0; b < size && left > 0; b++) {
+            uint8_t byte = word[endian == 1 ? size - b - 1 : b];
+            size_t  bits = left < 8 ? left : 8;
+
+            acc      |= (uint64_t) (byte & (0xFFu >> (8 - bits))) << acc_bits;
+            acc_bits += bits;
+            left     -= bits;
+
+            if (acc_bits >= 32) {
+                limbs[total_limbs - ++limb] = (uint32_t) acc;
+                acc      >>= 32;
+                acc_bits  -= 32;
+            }
+        }
+    }
+
+    if (acc_bits > 0) {
+        limbs[total_limbs - ++limb] = (uint32_t) acc;
+    }
+
+    return true;
+}
+
+void* bigint_export(void* dst, size_t* count, int order, size_t size, int endian, size_t nails, bigint_t* number)
+{
+    size_t          used;
+    const uint32_t* limbs     = bigint_limbs(number, &used);
+    size_t          word_bits = size * 8 - nails;
+    size_t          bits      = 0;
+
+    if (endian == 0) {
+        endian = BIGINT_NATIVE_ENDIAN;
+    }
+
+    if (used > 0) {
+        bits = used * 32;
+        for (uint32_t top = limbs[0]; (top & 0x80000000u) == 0; top <<= 1) {
+            bits--;
+        }
+    }
+
+    size_t words = (bits + word_bits - 1) / word_bits;
+    if (count != NULL) {
+        *count = words;
+    }
+
+    if (words == 0) {
+        return dst;
+    }
+
+    if (dst == NULL) {
+        dst = malloc(words * size);
+        if (dst == NULL) {
+            return NULL;
+        }
+    }
+
+    uint8_t* bytes = dst;
+
+    // Same layout as ours, a single copy does it.
+    if (size == sizeof(uint32_t) && nails == 0 && order == 1 && endian == BIGINT_NATIVE_ENDIAN) {
+        memcpy(dst, limbs, used * sizeof(uint32_t));
+        return dst;
+    }
+
+    uint64_t acc      = 0;
+    size_t   acc_bits = 0;
+    size_t   limb     = 0;
+
+    for (size_t w = 0; w < words; w++) {
+        uint8_t* word = bytes + (order == 1 ? words - w - 1 : w) * size;
+        size_t   left = word_bits;
+
+        for (size_t b = 0; b < size; b++) {
+            size_t take = left < 8 ? left : 8;
+
+            if (acc_bits < take && limb < used) {
+                acc      |= (uint64_t) limbs[used - ++limb] << acc_bits;
+                acc_bits += 32;
+            }
+
+            // Nail bits (take == 0) come out as zeroes.
+            word[endian == 1 ? size - b - 1 : b] = (uint8_t) (acc & (0xFFu >> (8 - take)));
+
+            acc      >>= take;
+            acc_bits  -= acc_bits < take ? acc_bits : take;
+            left      -= take;
+        }
+    }
+
+    return dst;
+}
+
+// Resizes number to exactly `size` limbs and makes sure it can be written to.
+// Existing limbs stay at the right end, so operands aliasing it keep their value.
+static uint32_t* bigint_prepare(bigint_t* number, size_t size)
+{
+    if (!ARRAY_RESIZE_R(number, size) || !bigint_unshare(number)) {
+        return NULL;
+    }
+    return (uint32_t*) number->items;
+}
+
+// number = limbs[n], which must not point into number.
+static bool bigint_assign(bigint_t* number, const uint32_t* limbs, size_t n)
+{
+    size_t    zeros = limb_leading_zeros(limbs, n);
+    uint32_t* out   = bigint_prepare(number, n - zeros);
+
+    if (out == NULL && n > zeros) {
+        return false;
+    }
+
+    if (n > zeros) {
+        memcpy(out, limbs + zeros, (n - zeros) * sizeof(uint32_t));
+    }
+    return true;
+}
+
+bool bigint_set_u32(bigint_t* number, uint32_t value)
+{
+    return bigint_set_u64(number, value);
+}
+
+bool bigint_set_u64(bigint_t* number, uint64_t value)
+{
+    size_t    size  = value == 0 ? 0 : (value >> 32) == 0 ? 1 : 2;
+    uint32_t* limbs = bigint_prepare(number, size);
+
+    if (limbs == NULL && size > 0) {
+        return false;
+    }
+
+    for (size_t i = size; i > 0; i--) {
+        limbs[i - 1] = (uint32_t) value;
+        value >>= 32;
+    }
+
+    return true;
+}
+
+uint64_t bigint_get_u64(bigint_t* number)
+{
+    return (uint64_t) bigint_limb(number, 1) << 32 | bigint_limb(number, 0);
+}
+
+bool bigint_copy(bigint_t* dst, bigint_t* src)
+{
+    if (dst == src) {
+        return true;
+    }
+
+    size_t          used;
+    const uint32_t* limbs = bigint_limbs(src, &used);
+    uint32_t*       out   = bigint_prepare(dst, used);
+
+    if (out == NULL && used > 0) {
+        return false;
+    }
+
+    if (used > 0) {
+        memcpy(out, limbs, used * sizeof(uint32_t));
+    }
+    return true;
+}
+
+void bigint_swap(bigint_t* a, bigint_t* b)
+{
+    bigint_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+bool bigint_trim(bigint_t* number)
+{
+    size_t used;
+    bigint_limbs(number, &used);
+    return ARRAY_RESIZE_R(number, used);
+}
+
+bool bigint_is_zero(bigint_t* number)
+{
+    size_t used;
+    bigint_limbs(number, &used);
+    return used == 0;
+}
+
+size_t bigint_bitlen(bigint_t* number)
+{
+    size_t          used;
+    const uint32_t* limbs = bigint_limbs(number, &used);
+
+    if (used == 0) {
+        return 0;
+    }
+
+    return used * 32 - (size_t) __builtin_clz(limbs[0]);
+}
+
+int bigint_cmp(bigint_t* a, bigint_t* b)
+{
+    size_t          an, bn;
+    const uint32_t* al = bigint_limbs(a, &an);
+    const uint32_t* bl = bigint_limbs(b, &bn);
+
+    if (an != bn) {
+        return an < bn ? -1 : 1;
+    }
+
+    return limb_cmp(al, bl, an);
+}
+
+bool bigint_add(bigint_t* result, bigint_t* a, bigint_t* b)
+{
+    size_t an, bn;
+    bigint_limbs(a, &an);
+    bigint_limbs(b, &bn);
+
+    if (an < bn) {
+        bigint_t* tmp = a;
+        a  = b;
+        b  = tmp;
+        an = bn;
+        bigint_limbs(b, &bn);
+    }
+
+    uint32_t* limbs = bigint_prepare(result, an + 1);
+    if (limbs == NULL) {
+        return false;
+    }
+
+    // Fetched after preparing, result may be one of them.
+    const uint32_t* al = bigint_limbs(a, &an);
+    const uint32_t* bl = bigint_limbs(b, &bn);
+
+    BIGINT_COUNT(BIGINT_STAT_ADD, an);
+    limbs[0] = limb_add(limbs + 1, al, an, bl, bn);
+    return bigint_trim(result);
+}
+
+bool bigint_add_u32(bigint_t* result, bigint_t* a, uint32_t b)
+{
+    bigint_t view;
+    bigint_wrap(&view, &b, 1);
+    return bigint_add(result, a, &view);
+}
+
+bool bigint_sub(bigint_t* result, bigint_t* a, bigint_t* b)
+{
+    if (bigint_cmp(a, b) < 0) {
+        return false;
+    }
+
+    size_t an, bn;
+    bigint_limbs(a, &an);
+
+    if (an == 0) {
+        return bigint_set_u32(result, 0);
+    }
+
+    uint32_t* limbs = bigint_prepare(result, an);
+    if (limbs == NULL) {
+        return false;
+    }
+
+    const uint32_t* al = bigint_limbs(a, &an);
+    const uint32_t* bl = bigint_limbs(b, &bn);
+
+    BIGINT_COUNT(BIGINT_STAT_SUB, an);
+    limb_sub(limbs, al, an, bl, bn);
+    return bigint_trim(result);
+}
+
+bool bigint_sub_u32(bigint_t* result, bigint_t* a, uint32_t b)
+{
+    bigint_t view;
+    bigint_wrap(&view, &b, 1);
+    return bigint_sub(result, a, &view);
+}
+
+bool bigint_shl(bigint_t* result, bigint_t* a, size_t bits)
+{
+    size_t an;
+    bigint_limbs(a, &an);
+
+    if (an == 0) {
+        return bigint_set_u32(result, 0);
+    }
+
+    size_t    shift = bits / 32;
+    uint32_t* limbs = bigint_prepare(result, an + shift + 1);
+    if (limbs == NULL) {
+        return false;
+    }
+
+    // Moves a to the front first, then shifts the remaining bits in place.
+    const uint32_t* al = bigint_limbs(a, &an);
+    memmove(limbs + 1, al, an * sizeof(uint32_t));
+    memset(limbs + 1 + an, 0, shift * sizeof(uint32_t));
+
+    BIGINT_COUNT(BIGINT_STAT_SHIFT, an);
+    limbs[0] = limb_lshift(limbs + 1, limbs + 1, an, (unsigned) (bits % 32));
+    return bigint_trim(result);
+}
+
+bool bigint_shr(bigint_t* result, bigint_t* a, size_t bits)
+{
+    size_t an;
+    bigint_limbs(a, &an);
+
+    size_t shift = bits / 32;
+    if (shift >= an) {
+        return bigint_set_u32(result, 0);
+    }
+
+    if (!bigint_copy(result, a) || !bigint_trim(result) || !bigint_unshare(result)) {
+        return false;
+    }
+
+    // Shifts the leading limbs in place, then drops the ones shifted out.
+    uint32_t* limbs = (uint32_t*) result->items;
+    BIGINT_COUNT(BIGINT_STAT_SHIFT, an);
+    limb_rshift(limbs, limbs, an - shift, (unsigned) (bits % 32));
+
+    return ARRAY_RESIZE_L(result, an - shift) && bigint_trim(result);
+}
+
+bool bigint_mul(bigint_t* result, bigint_t* a, bigint_t* b)
+{
+    size_t          an, bn;
+    const uint32_t* al = bigint_limbs(a, &an);
+    const uint32_t* bl = bigint_limbs(b, &bn);
+
+    if (an == 0 || bn == 0) {
+        return bigint_set_u32(result, 0);
+    }
+
+    // The product can't be built in place, it goes below the scratch limb_mul
+    // needs and is copied out at the end.
+    scratch_frame_t frame;
+    uint32_t*       product = scratch_push(&frame, an + bn + limb_mul_scratch(MAX(an, bn)));
+
+    if (product == NULL) {
+        return false;
+    }
+
+    BIGINT_TIME_BEGIN(BIGINT_STAT_MUL, timer, an + bn);
+    limb_mul(product, al, an, bl, bn, product + an + bn);
+    BIGINT_TIME_END(timer);
+
+    bool ok = bigint_assign(result, product, an + bn);
+    scratch_pop(&frame);
+    return ok;
+}
+
+bool bigint_mul_u32(bigint_t* result, bigint_t* a, uint32_t b)
+{
+    size_t an;
+    bigint_limbs(a, &an);
+
+    if (an == 0 || b == 0) {
+        return bigint_set_u32(result, 0);
+    }
+
+    // Leave room for the carry, a keeps its value at the right end if aliased.
+    if (result != a && !bigint_copy(result, a)) {
+        return false;
+    }
+
+    uint32_t* limbs = bigint_prepare(result, an + 1);
+    if (limbs == NULL) {
+        return false;
+    }
+
+    limbs[0] = limb_mul_1(limbs + 1, limbs + 1, an, b);
+    return bigint_trim(result);
+}
+
+bool bigint_divmod(bigint_t* quotient, bigint_t* remainder, bigint_t* a, bigint_t* d)
+{
+    size_t          an, dn;
+    const uint32_t* al = bigint_limbs(a, &an);
+    const uint32_t* dl = bigint_limbs(d, &dn);
+
+    if (dn == 0) {
+        return false;
+    }
+
+    if (an < dn) {
+        if (remainder != NULL && !bigint_copy(remainder, a)) {
+            return false;
+        }
+        return quotient == NULL || bigint_set_u32(quotient, 0);
+    }
+
+    // Quotient and remainder go on the scratch stack, followed by what
+    // limb_divmod takes, as the operands may alias them.
+    scratch_frame_t frame;
+    size_t          qn = an - dn + 1;
+    uint32_t*       q  = scratch_push(&frame, qn + dn + limb_divmod_scratch(an, dn));
+
+    if (q == NULL) {
+        return false;
+    }
+
+    BIGINT_TIME_BEGIN(BIGINT_STAT_DIVMOD, timer, an);
+    limb_divmod(q, q + qn, al, an, dl, dn, q + qn + dn);
+    BIGINT_TIME_END(timer);
+
+    bool ok = (quotient == NULL || bigint_assign(quotient, q, qn))
+           && (remainder == NULL || bigint_assign(remainder, q + qn, dn));
+
+    scratch_pop(&frame);
+    return ok;
+}
+
+bool bigint_divmod_u32(bigint_t* quotient, uint32_t* remainder, bigint_t* a, uint32_t d)
+{
+    if (d == 0) {
+        return false;
+    }
+
+    size_t          an;
+    const uint32_t* al = bigint_limbs(a, &an);
+
+    if (quotient == NULL) {
+        uint32_t rem = limb_divmod_1(NULL, al, an, d);
+        if (remainder != NULL) {
+            *remainder = rem;
+        }
+        return true;
+    }
+
+    if (quotient != a && !bigint_copy(quotient, a)) {
+        return false;
+    }
+
+    uint32_t* limbs = bigint_prepare(quotient, an);
+    if (limbs == NULL && an > 0) {
+        return false;
+    }
+
+    uint32_t rem = limb_divmod_1(limbs, limbs, an, d);
+    if (remainder != NULL) {
+        *remainder = rem;
+    }
+
+    return bigint_trim(quotient);
+}
+
+bool bigint_pow_u32(bigint_t* result, bigint_t* a, uint32_t exponent)
+{
+    bigint_t* base = bigint_new();
+    if (base == NULL) {
+        return false;
+    }
+
+    // Left to right square and multiply, a may be result.
+    bool ok = bigint_copy(base, a) && bigint_set_u32(result, 1);
+
+    for (int bit = 31 - __builtin_clz(exponent | 1); ok && bit >= 0; bit--) {
+        ok = bigint_mul(result, result, result);
+        if (ok && (exponent >> bit) & 1) {
+            ok = bigint_mul(result, result, base);
+        }
+    }
+
+    bigint_delete(base);
+    return ok;
+}
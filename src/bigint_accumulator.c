@@ -0,0 +1,298 @@
+#include "bigint_accumulator.h"
+#include "bigint_tune.h"
+
+#include<string.h>
+
+#define BIGINT_ACCUMULATOR_COLUMN(acc, i) ((uint64_t*) ARRAY_GET((acc)->columns, i))
+#define BIGINT_ACCUMULATOR_LEVEL(acc, i)  ((bigint_t**) ARRAY_GET((acc)->levels, i))
+
+// Leaves grow up to where multiplications stop being schoolbook.
+static size_t bigint_accumulator_leaf_limbs(void)
+{
+    return MAX(bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA), 2);
+}
+
+bool bigint_accumulator_init(bigint_accumulator_t* acc, bigint_accumulator_op_t op)
+{
+    memset(acc, 0, sizeof(*acc));
+    acc->op = op;
+
+    if (op == BIGINT_ACCUMULATE_SUM) {
+        acc->columns = ARRAY_NEW(uint64_t);
+        return acc->columns != NULL;
+    }
+
+    acc->leaf   = bigint_new();
+    acc->levels = ARRAY_NEW(bigint_t*);
+
+    if (acc->leaf == NULL || acc->levels == NULL || !bigint_set_u32(acc->leaf, 1)) {
+        bigint_accumulator_free(acc);
+        return false;
+    }
+    return true;
+}
+
+// Drops the partial products, keeping the memory of the levels.
+static void bigint_accumulator_clear_levels(bigint_accumulator_t* acc)
+{
+    for (size_t i = 0; i < acc->levels->size; i++) {
+        bigint_t** level = BIGINT_ACCUMULATOR_LEVEL(acc, i);
+        if (*level != NULL) {
+            bigint_delete(*level);
+        }
+    }
+
+    ARRAY_RESIZE(acc->levels, 0);
+}
+
+void bigint_accumulator_free(bigint_accumulator_t* acc)
+{
+    if (acc->levels != NULL) {
+        bigint_accumulator_clear_levels(acc);
+        array_delete(acc->levels);
+    }
+    if (acc->leaf != NULL) {
+        bigint_delete(acc->leaf);
+    }
+    if (acc->columns != NULL) {
+        array_delete(acc->columns);
+    }
+
+    memset(acc, 0, sizeof(*acc));
+}
+
+// Propagates the carries, every column ends up below 2^32. The carry out of
+// the top fits in two more columns, made room for first so nothing is lost
+// when that fails.
+static bool bigint_accumulator_normalize(bigint_accumulator_t* acc)
+{
+    size_t n = acc->columns->size;
+
+    if (!ARRAY_RESIZE(acc->columns, n + 2)) {
+        return false;
+    }
+
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < n + 2; i++) {
+        uint64_t* column = BIGINT_ACCUMULATOR_COLUMN(acc, i);
+        uint64_t  low    = (*column & 0xFFFFFFFFu) + (carry & 0xFFFFFFFFu);
+
+        carry   = (*column >> 32) + (carry >> 32) + (low >> 32);
+        *column = low & 0xFFFFFFFFu;
+    }
+
+    size_t used = n + 2;
+    while (used > n && *BIGINT_ACCUMULATOR_COLUMN(acc, used - 1) == 0) {
+        used--;
+    }
+    ARRAY_RESIZE(acc->columns, used);
+
+    acc->pending = 0;
+    return true;
+}
+
+// Every column is below 2^32 after a normalization and takes less than 2^32
+// more from every value, so 2^32 - 1 values fit before the next one, which
+// is done before the value goes in.
+static bool bigint_accumulator_add(bigint_accumulator_t* acc, const uint32_t* limbs, size_t n)
+{
+    if (acc->pending == UINT32_MAX && !bigint_accumulator_normalize(acc)) {
+        return false;
+    }
+
+    if (n > acc->columns->size && !ARRAY_RESIZE(acc->columns, n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        *BIGINT_ACCUMULATOR_COLUMN(acc, i) += limbs[n - 1 - i];
+    }
+
+    acc->count++;
+    acc->pending++;
+    return true;
+}
+
+// Takes number, the product of about 2^level leaves, and carries it up the
+// counter: wherever a level is taken, the two are multiplied and move up.
+// The product is built on the side, so when that fails the levels are as
+// they were and number is still the caller's.
+static bool bigint_accumulator_insert(bigint_accumulator_t* acc, bigint_t* number, size_t level)
+{
+    size_t top = level;
+
+    while (top < acc->levels->size && *BIGINT_ACCUMULATOR_LEVEL(acc, top) != NULL) {
+        top++;
+    }
+
+    if (top >= acc->levels->size && !ARRAY_RESIZE(acc->levels, top + 1)) {
+        return false;
+    }
+
+    bigint_t* product = number;
+
+    if (top > level) {
+        product = bigint_new();
+        bool ok = product != NULL && bigint_mul(product, number, *BIGINT_ACCUMULATOR_LEVEL(acc, level));
+
+        for (size_t i = level + 1; ok && i < top; i++) {
+            ok = bigint_mul(product, product, *BIGINT_ACCUMULATOR_LEVEL(acc, i));
+        }
+
+        if (!ok) {
+            if (product != NULL) {
+                bigint_delete(product);
+            }
+            return false;
+        }
+
+        bigint_delete(number);
+        for (size_t i = level; i < top; i++) {
+            bigint_t** slot = BIGINT_ACCUMULATOR_LEVEL(acc, i);
+            bigint_delete(*slot);
+            *slot = NULL;
+        }
+    }
+
+    *BIGINT_ACCUMULATOR_LEVEL(acc, top) = product;
+    return true;
+}
+
+// A full leaf stays where it is until it's merged into the levels.
+static bool bigint_accumulator_flush_leaf(bigint_accumulator_t* acc)
+{
+    bigint_t* leaf = bigint_new();
+
+    if (leaf == NULL || !bigint_set_u32(leaf, 1) || !bigint_accumulator_insert(acc, acc->leaf, 0)) {
+        if (leaf != NULL) {
+            bigint_delete(leaf);
+        }
+        return false;
+    }
+
+    acc->leaf = leaf;
+    return true;
+}
+
+// Full leaves are flushed before the next value goes in, so a push that
+// fails leaves the value out and can be retried.
+bool bigint_accumulator_push_u32(bigint_accumulator_t* acc, uint32_t value)
+{
+    if (acc->op == BIGINT_ACCUMULATE_SUM) {
+        return value == 0 || bigint_accumulator_add(acc, &value, 1);
+    }
+
+    if (acc->leaf->size >= bigint_accumulator_leaf_limbs() && !bigint_accumulator_flush_leaf(acc)) {
+        return false;
+    }
+
+    if (!bigint_mul_u32(acc->leaf, acc->leaf, value)) {
+        return false;
+    }
+
+    acc->count++;
+    return true;
+}
+
+bool bigint_accumulator_push(bigint_accumulator_t* acc, bigint_t* value)
+{
+    size_t          n;
+    const uint32_t* limbs = bigint_limbs(value, &n);
+
+    if (acc->op == BIGINT_ACCUMULATE_SUM) {
+        return n == 0 || bigint_accumulator_add(acc, limbs, n);
+    }
+
+    if (n <= 1) {
+        return bigint_accumulator_push_u32(acc, n == 1 ? limbs[0] : 0);
+    }
+
+    // Short ones go into the leaf, the others start at the level of their
+    // size, where the partial products are about as long.
+    size_t leaf = bigint_accumulator_leaf_limbs();
+
+    if (acc->leaf->size + n <= leaf) {
+        if (!bigint_mul(acc->leaf, acc->leaf, value)) {
+            return false;
+        }
+
+        acc->count++;
+        return true;
+    }
+
+    size_t level = 0;
+    while (leaf << (level + 1) <= n) {
+        level++;
+    }
+
+    bigint_t* copy = bigint_new();
+    if (copy == NULL || !bigint_copy(copy, value) || !bigint_accumulator_insert(acc, copy, level)) {
+        if (copy != NULL) {
+            bigint_delete(copy);
+        }
+        return false;
+    }
+
+    acc->count++;
+    return true;
+}
+
+static bool bigint_accumulator_finish_sum(bigint_accumulator_t* acc, bigint_t* result)
+{
+    if (!bigint_accumulator_normalize(acc)) {
+        return false;
+    }
+
+    size_t n = acc->columns->size;
+
+    if (!bigint_set_u32(result, 0) || !bigint_resize(result, n) || !bigint_unshare(result)) {
+        return false;
+    }
+
+    uint32_t* limbs = (uint32_t*) result->items;
+    for (size_t i = 0; i < n; i++) {
+        limbs[n - 1 - i] = (uint32_t) *BIGINT_ACCUMULATOR_COLUMN(acc, i);
+    }
+
+    ARRAY_RESIZE(acc->columns, 0);
+    return bigint_trim(result);
+}
+
+static bool bigint_accumulator_finish_product(bigint_accumulator_t* acc, bigint_t* result)
+{
+    // From the smallest up, what's gathered so far stays shorter than the
+    // next level. Levels go once they're in the leaf, so a failure keeps
+    // the product whole.
+    for (size_t i = 0; i < acc->levels->size; i++) {
+        bigint_t** level = BIGINT_ACCUMULATOR_LEVEL(acc, i);
+
+        if (*level != NULL) {
+            if (!bigint_mul(acc->leaf, acc->leaf, *level)) {
+                return false;
+            }
+
+            bigint_delete(*level);
+            *level = NULL;
+        }
+    }
+
+    if (!bigint_copy(result, acc->leaf) || !bigint_set_u32(acc->leaf, 1)) {
+        return false;
+    }
+
+    ARRAY_RESIZE(acc->levels, 0);
+    return true;
+}
+
+bool bigint_accumulator_finish(bigint_accumulator_t* acc, bigint_t* result)
+{
+    bool ok = acc->op == BIGINT_ACCUMULATE_SUM
+            ? bigint_accumulator_finish_sum(acc, result)
+            : bigint_accumulator_finish_product(acc, result);
+
+    if (ok) {
+        acc->count = 0;
+    }
+    return ok;
+}
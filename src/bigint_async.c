@@ -0,0 +1,388 @@
+#include "bigint_async.h"
+#include "bigint_io.h"
+#include "job.h"
+#include "limb.h"
+
+#include<math.h>
+#include<pthread.h>
+#include<unistd.h>
+
+_Thread_local job_state_t* job_current;
+
+struct bigint_job_s
+{
+    job_state_t    state;
+    atomic_int     status;   // bigint_job_status_t
+    pthread_cond_t finished; // Signalled under the pool lock
+
+    bool (*run)(bigint_job_t* job);
+    bigint_t*      a;
+    bigint_t*      b;        // May be a
+    unsigned       base;
+
+    bigint_t*      result;
+    char*          string;
+
+    bigint_job_t*  next;     // In the queue
+};
+
+typedef struct bigint_async_pool_s
+{
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;     // Jobs queued, or stopping
+    bigint_job_t*   head;
+    bigint_job_t*   tail;
+
+    pthread_t*      workers;
+    size_t          count;    // Running
+    size_t          threads;  // Wanted, 0 for one per CPU
+    bool            stopping;
+} bigint_async_pool_t;
+
+static bigint_async_pool_t bigint_async_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+static void* bigint_async_worker(void* arg)
+{
+    bigint_async_pool_t* pool = &bigint_async_pool;
+    (void) arg;
+
+    pthread_mutex_lock(&pool->lock);
+
+    for (;;) {
+        while (pool->head == NULL && !pool->stopping) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        // Stopping only once the queue is drained.
+        bigint_job_t* job = pool->head;
+        if (job == NULL) {
+            break;
+        }
+
+        pool->head = job->next;
+        if (pool->head == NULL) {
+            pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        job_current = &job->state;
+        bool ok     = job->run(job);
+        job_current = NULL;
+
+        // Cancelled work may have stopped halfway and still returned true.
+        bigint_job_status_t status = atomic_load(&job->state.cancelled) ? BIGINT_JOB_CANCELLED
+                                   : ok                                 ? BIGINT_JOB_DONE
+                                                                        : BIGINT_JOB_FAILED;
+
+        pthread_mutex_lock(&pool->lock);
+        atomic_store(&job->status, (int) status);
+        pthread_cond_broadcast(&job->finished);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Under the pool lock. True when at least one worker is running.
+static bool bigint_async_start(bigint_async_pool_t* pool)
+{
+    size_t threads = pool->threads;
+
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads   = cpus > 0 ? (size_t) cpus : 1;
+    }
+
+    pool->workers = malloc(threads * sizeof(pthread_t));
+    if (pool->workers == NULL) {
+        return false;
+    }
+
+    while (pool->count < threads && pthread_create(&pool->workers[pool->count], NULL, bigint_async_worker, NULL) == 0) {
+        pool->count++;
+    }
+
+    if (pool->count == 0) {
+        free(pool->workers);
+        pool->workers = NULL;
+        return false;
+    }
+    return true;
+}
+
+void bigint_async_set_threads(size_t threads)
+{
+    pthread_mutex_lock(&bigint_async_pool.lock);
+    bigint_async_pool.threads = threads;
+    pthread_mutex_unlock(&bigint_async_pool.lock);
+}
+
+void bigint_async_shutdown(void)
+{
+    bigint_async_pool_t* pool = &bigint_async_pool;
+
+    // The workers are taken out of the pool, a shutdown running alongside
+    // finds none left to stop. Jobs are refused until they're all joined.
+    pthread_mutex_lock(&pool->lock);
+
+    pthread_t* workers = pool->workers;
+    size_t     count   = pool->count;
+
+    if (count == 0) {
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+
+    pool->workers  = NULL;
+    pool->count    = 0;
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = false;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// The job's own handle on a number.
+static bigint_t* bigint_async_hold(bigint_t* number)
+{
+    if (!number->borrowed) {
+        return bigint_share(number);
+    }
+
+    bigint_t* copy = bigint_new();
+    if (copy != NULL && !bigint_copy(copy, number)) {
+        bigint_delete(copy);
+        copy = NULL;
+    }
+    return copy;
+}
+
+static void bigint_job_free(bigint_job_t* job)
+{
+    if (job->b != NULL && job->b != job->a) {
+        bigint_delete(job->b);
+    }
+    if (job->a != NULL) {
+        bigint_delete(job->a);
+    }
+    if (job->result != NULL) {
+        bigint_delete(job->result);
+    }
+
+    free(job->string);
+    pthread_cond_destroy(&job->finished);
+    free(job);
+}
+
+static bigint_job_t* bigint_job_new(bool (*run)(bigint_job_t* job), job_work_t work, bigint_t* a, bigint_t* b)
+{
+    bigint_job_t* job = calloc(1, sizeof(bigint_job_t));
+
+    if (job == NULL) {
+        return NULL;
+    }
+
+    job->state.work = work;
+    atomic_init(&job->state.done, 0);
+    atomic_init(&job->state.cancelled, false);
+    atomic_init(&job->status, BIGINT_JOB_RUNNING);
+    pthread_cond_init(&job->finished, NULL);
+
+    job->run = run;
+    job->a   = bigint_async_hold(a);
+    job->b   = b == NULL || b == a ? job->a : bigint_async_hold(b);
+
+    if (job->a == NULL || job->b == NULL) {
+        bigint_job_free(job);
+        return NULL;
+    }
+    return job;
+}
+
+static bigint_job_t* bigint_job_submit(bigint_job_t* job)
+{
+    bigint_async_pool_t* pool = &bigint_async_pool;
+
+    pthread_mutex_lock(&pool->lock);
+
+    // Workers that are stopping may already be gone, nothing would run it.
+    bool ok = !pool->stopping && (pool->count > 0 || bigint_async_start(pool));
+
+    if (ok) {
+        if (pool->tail != NULL) {
+            pool->tail->next = job;
+        } else {
+            pool->head = job;
+        }
+        pool->tail = job;
+        pthread_cond_signal(&pool->wake);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!ok) {
+        bigint_job_free(job);
+        return NULL;
+    }
+    return job;
+}
+
+static bool bigint_job_run_mul(bigint_job_t* job)
+{
+    return bigint_mul(job->result, job->a, job->b);
+}
+
+static bool bigint_job_run_to_string(bigint_job_t* job)
+{
+    job->string = bigint_to_string(job->a, job->base);
+    return job->string != NULL;
+}
+
+bigint_job_t* bigint_mul_async(bigint_t* a, bigint_t* b)
+{
+    bigint_job_t* job = bigint_job_new(bigint_job_run_mul, JOB_WORK_MUL, a, b);
+
+    if (job == NULL) {
+        return NULL;
+    }
+
+    job->result = bigint_new();
+    if (job->result == NULL) {
+        bigint_job_free(job);
+        return NULL;
+    }
+
+    size_t an, bn;
+    bigint_limbs(job->a, &an);
+    bigint_limbs(job->b, &bn);
+    job->state.total = an == 0 || bn == 0 ? 0 : limb_mul_work(an, bn, job->a == job->b);
+
+    return bigint_job_submit(job);
+}
+
+bigint_job_t* bigint_to_string_async(bigint_t* number, unsigned base)
+{
+    bigint_job_t* job = bigint_job_new(bigint_job_run_to_string, JOB_WORK_DIGITS, number, NULL);
+
+    if (job == NULL) {
+        return NULL;
+    }
+
+    job->base = base;
+    if (base >= 2) {
+        job->state.total = (uint64_t) ((double) bigint_bitlen(number) / log2(base)) + 1;
+    }
+
+    return bigint_job_submit(job);
+}
+
+bigint_job_status_t bigint_job_poll(bigint_job_t* job)
+{
+    return (bigint_job_status_t) atomic_load(&job->status);
+}
+
+bigint_job_status_t bigint_job_wait(bigint_job_t* job)
+{
+    bigint_async_pool_t* pool = &bigint_async_pool;
+
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&job->status) == BIGINT_JOB_RUNNING) {
+        pthread_cond_wait(&job->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return bigint_job_poll(job);
+}
+
+void bigint_job_cancel(bigint_job_t* job)
+{
+    bigint_async_pool_t* pool = &bigint_async_pool;
+
+    atomic_store(&job->state.cancelled, true);
+
+    // Taken off the queue if it's still there, no worker will see it.
+    pthread_mutex_lock(&pool->lock);
+
+    bigint_job_t* prev = NULL;
+    for (bigint_job_t* queued = pool->head; queued != NULL; prev = queued, queued = queued->next) {
+        if (queued != job) {
+            continue;
+        }
+
+        if (prev != NULL) {
+            prev->next = job->next;
+        } else {
+            pool->head = job->next;
+        }
+        if (pool->tail == job) {
+            pool->tail = prev;
+        }
+
+        atomic_store(&job->status, BIGINT_JOB_CANCELLED);
+        pthread_cond_broadcast(&job->finished);
+        break;
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
+double bigint_job_progress(bigint_job_t* job)
+{
+    if (bigint_job_poll(job) == BIGINT_JOB_DONE) {
+        return 1.0;
+    }
+
+    uint64_t done = atomic_load_explicit(&job->state.done, memory_order_relaxed);
+
+    if (job->state.total == 0) {
+        return 0.0;
+    }
+
+    double progress = (double) done / (double) job->state.total;
+    return progress < 1.0 ? progress : 1.0;
+}
+
+bool bigint_job_result(bigint_job_t* job, bigint_t* result)
+{
+    if (bigint_job_poll(job) != BIGINT_JOB_DONE || job->result == NULL) {
+        return false;
+    }
+
+    bigint_swap(result, job->result);
+    bigint_delete(job->result);
+    job->result = NULL;
+    return true;
+}
+
+char* bigint_job_string(bigint_job_t* job)
+{
+    if (bigint_job_poll(job) != BIGINT_JOB_DONE) {
+        return NULL;
+    }
+
+    char* string = job->string;
+    job->string  = NULL;
+    return string;
+}
+
+void bigint_job_delete(bigint_job_t* job)
+{
+    if (bigint_job_poll(job) == BIGINT_JOB_RUNNING) {
+        bigint_job_cancel(job);
+    }
+
+    // Also when it was seen finished: the worker signals under the lock
+    // after setting the status, and is done with the job once it's free.
+    bigint_job_wait(job);
+    bigint_job_free(job);
+}
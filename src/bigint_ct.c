@@ -0,0 +1,292 @@
+#include "bigint_ct.h"
+#include "scratch.h"
+
+#include<string.h>
+
+// Keeps the compiler from seeing that a mask is all ones or zero, and so
+// from turning the arithmetic on it back into branches.
+static uint32_t bigint_ct_hide(uint32_t x)
+{
+#if defined(__GNUC__)
+    __asm__("" : "+r"(x));
+#endif
+    return x;
+}
+
+// All ones when x is 1, zero when it is 0.
+static uint32_t bigint_ct_mask(uint32_t bit)
+{
+    return bigint_ct_hide(0u - bit);
+}
+
+bool bigint_ct_import(uint32_t* r, size_t n, bigint_t* a)
+{
+    const uint32_t* limbs = (const uint32_t*) a->items;
+    size_t          size  = a->size;
+    uint32_t        over  = 0;
+
+    // The limbs that don't fit have to be zero, all of them are looked at.
+    for (size_t i = 0; i + n < size; i++) {
+        over |= limbs[i];
+    }
+
+    if (over != 0) {
+        return false;
+    }
+
+    memset(r, 0, n * sizeof(uint32_t));
+    for (size_t i = 0; i < n && i < size; i++) {
+        r[n - 1 - i] = limbs[size - 1 - i];
+    }
+    return true;
+}
+
+bool bigint_ct_export(bigint_t* result, const uint32_t* a, size_t n)
+{
+    if (!bigint_set_u32(result, 0) || !bigint_resize(result, n) || !bigint_unshare(result)) {
+        return false;
+    }
+
+    if (n > 0) {
+        memcpy(result->items, a, n * sizeof(uint32_t));
+    }
+    return true;
+}
+
+uint32_t bigint_ct_is_zero(const uint32_t* a, size_t n)
+{
+    uint32_t bits = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        bits |= a[i];
+    }
+
+    // The top bit of bits | -bits is set unless bits is zero.
+    return bigint_ct_mask(((bits | (0u - bits)) >> 31) ^ 1);
+}
+
+uint32_t bigint_ct_equals(const uint32_t* a, const uint32_t* b, size_t n)
+{
+    uint32_t bits = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        bits |= a[i] ^ b[i];
+    }
+
+    return bigint_ct_mask(((bits | (0u - bits)) >> 31) ^ 1);
+}
+
+// The borrow out of a - b, without keeping the difference.
+static uint32_t bigint_ct_borrow(const uint32_t* a, const uint32_t* b, size_t n)
+{
+    uint64_t borrow = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        borrow = ((uint64_t) a[i - 1] - b[i - 1] - borrow) >> 63;
+    }
+
+    return (uint32_t) borrow;
+}
+
+uint32_t bigint_ct_less(const uint32_t* a, const uint32_t* b, size_t n)
+{
+    return bigint_ct_mask(bigint_ct_borrow(a, b, n));
+}
+
+int bigint_ct_cmp(const uint32_t* a, const uint32_t* b, size_t n)
+{
+    return (int) bigint_ct_borrow(b, a, n) - (int) bigint_ct_borrow(a, b, n);
+}
+
+void bigint_ct_select(uint32_t* r, uint32_t mask, const uint32_t* a, const uint32_t* b, size_t n)
+{
+    mask = bigint_ct_hide(mask);
+
+    for (size_t i = 0; i < n; i++) {
+        r[i] = b[i] ^ (mask & (a[i] ^ b[i]));
+    }
+}
+
+void bigint_ct_swap(uint32_t mask, uint32_t* a, uint32_t* b, size_t n)
+{
+    mask = bigint_ct_hide(mask);
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t t = mask & (a[i] ^ b[i]);
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+uint32_t bigint_ct_add(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n)
+{
+    uint64_t carry = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        carry   += (uint64_t) a[i - 1] + b[i - 1];
+        r[i - 1] = (uint32_t) carry;
+        carry  >>= 32;
+    }
+
+    return (uint32_t) carry;
+}
+
+uint32_t bigint_ct_sub(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n)
+{
+    uint64_t borrow = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        uint64_t d = (uint64_t) a[i - 1] - b[i - 1] - borrow;
+        r[i - 1]   = (uint32_t) d;
+        borrow     = d >> 63;
+    }
+
+    return (uint32_t) borrow;
+}
+
+bool bigint_ct_addmod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    size_t          n = mont->size;
+    scratch_frame_t frame;
+    uint32_t*       t = scratch_push(&frame, n);
+
+    if (t == NULL) {
+        return false;
+    }
+
+    // a + b is below 2m, m comes off when it carried or is still at least m.
+    uint32_t carry  = bigint_ct_add(r, a, b, n);
+    uint32_t borrow = bigint_ct_sub(t, r, mont->modulus, n);
+    bigint_ct_select(r, bigint_ct_mask(carry | (borrow ^ 1)), t, r, n);
+
+    scratch_pop(&frame);
+    return true;
+}
+
+bool bigint_ct_submod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    size_t          n = mont->size;
+    scratch_frame_t frame;
+    uint32_t*       t = scratch_push(&frame, n);
+
+    if (t == NULL) {
+        return false;
+    }
+
+    uint32_t borrow = bigint_ct_sub(r, a, b, n);
+    bigint_ct_add(t, r, mont->modulus, n);
+    bigint_ct_select(r, bigint_ct_mask(borrow), t, r, n);
+
+    scratch_pop(&frame);
+    return true;
+}
+
+// r[n] = a[n] b[n] / R mod m, interleaving the product and the reduction a
+// limb of b at a time (CIOS). Unlike the one in bigint_mont.c, every carry
+// runs the full length and the last subtraction is a select. t has n + 2
+// limbs, least significant first.
+static void bigint_ct_redc(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t* t)
+{
+    size_t          n = mont->size;
+    const uint32_t* m = mont->modulus;
+
+    memset(t, 0, (n + 2) * sizeof(uint32_t));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bi    = b[n - 1 - i];
+        uint64_t carry = 0;
+
+        for (size_t j = 0; j < n; j++) {
+            carry += t[j] + a[n - 1 - j] * bi;
+            t[j]   = (uint32_t) carry;
+            carry >>= 32;
+        }
+        carry   += t[n];
+        t[n]     = (uint32_t) carry;
+        t[n + 1] = (uint32_t) (carry >> 32);
+
+        // Adding q m clears the lowest limb, which is shifted out.
+        uint64_t q = (uint32_t) (t[0] * mont->inverse);
+
+        carry = ((uint64_t) t[0] + q * m[n - 1]) >> 32;
+        for (size_t j = 1; j < n; j++) {
+            carry   += t[j] + q * m[n - 1 - j];
+            t[j - 1] = (uint32_t) carry;
+            carry  >>= 32;
+        }
+        carry   += t[n];
+        t[n - 1] = (uint32_t) carry;
+        t[n]     = t[n + 1] + (uint32_t) (carry >> 32);
+    }
+
+    // t is below 2m, m comes off when t[n] is set or t[0, n) is at least m.
+    uint64_t borrow = 0;
+    for (size_t j = 0; j < n; j++) {
+        uint64_t d   = (uint64_t) t[j] - m[n - 1 - j] - borrow;
+        borrow       = d >> 63;
+        r[n - 1 - j] = t[j];
+        t[j]         = (uint32_t) d;
+    }
+
+    uint32_t mask = bigint_ct_mask(t[n] | ((uint32_t) borrow ^ 1));
+    for (size_t j = 0; j < n; j++) {
+        r[n - 1 - j] ^= mask & (r[n - 1 - j] ^ t[j]);
+    }
+}
+
+bool bigint_ct_mulmod(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    size_t          n = mont->size;
+    scratch_frame_t frame;
+    uint32_t*       t = scratch_push(&frame, 2 * n + 2);
+
+    if (t == NULL) {
+        return false;
+    }
+
+    // a b / R, then times R^2 / R.
+    uint32_t* x = t + n + 2;
+    bigint_ct_redc(mont, x, a, b, t);
+    bigint_ct_redc(mont, r, x, mont->r2, t);
+
+    scratch_pop(&frame);
+    return true;
+}
+
+bool bigint_ct_powm(bigint_mont_t* mont, uint32_t* r, const uint32_t* base, const uint32_t* exponent, size_t en)
+{
+    size_t          n = mont->size;
+    scratch_frame_t frame;
+    uint32_t*       t = scratch_push(&frame, 3 * n + 2);
+
+    if (t == NULL) {
+        return false;
+    }
+
+    // The ladder keeps x1 = x0 base, both in Montgomery form.
+    uint32_t* x0 = t + n + 2;
+    uint32_t* x1 = x0 + n;
+
+    memcpy(x0, mont->one, n * sizeof(uint32_t));
+    bigint_ct_redc(mont, x1, base, mont->r2, t);
+
+    for (size_t i = 0; i < 32 * en; i++) {
+        uint32_t limb = exponent[i / 32];
+        uint32_t bit  = bigint_ct_mask((limb >> (31 - i % 32)) & 1);
+
+        // x0 x1 goes to x1 for a one bit and to x0 for a zero, the square
+        // of the other one takes its place.
+        bigint_ct_swap(bit, x0, x1, n);
+        bigint_ct_redc(mont, x1, x0, x1, t);
+        bigint_ct_redc(mont, x0, x0, x0, t);
+        bigint_ct_swap(bit, x0, x1, n);
+    }
+
+    // Out of Montgomery form, times 1 / R.
+    memset(x1, 0, n * sizeof(uint32_t));
+    x1[n - 1] = 1;
+    bigint_ct_redc(mont, r, x0, x1, t);
+
+    scratch_pop(&frame);
+    return true;
+}
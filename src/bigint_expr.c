@@ -0,0 +1,341 @@
+#include "bigint_expr.h"
+#include "limb.h"
+#include "scratch.h"
+
+#include<stdlib.h>
+#include<string.h>
+
+void bigint_expr_init(bigint_expr_t* expr)
+{
+    memset(expr, 0, sizeof(*expr));
+}
+
+void bigint_expr_free(bigint_expr_t* expr)
+{
+    free(expr->items);
+    memset(expr, 0, sizeof(*expr));
+}
+
+void bigint_expr_clear(bigint_expr_t* expr)
+{
+    expr->count = 0;
+}
+
+static bigint_expr_node_t bigint_expr_push(bigint_expr_t* expr, bigint_expr_op_t op, bigint_expr_node_t left, bigint_expr_node_t right)
+{
+    bool binary = op == BIGINT_EXPR_ADD || op == BIGINT_EXPR_SUB || op == BIGINT_EXPR_MUL;
+
+    // Children come first, so the nodes are always in evaluation order.
+    if (binary && (left >= expr->count || right >= expr->count)) {
+        return BIGINT_EXPR_NONE;
+    }
+
+    if (expr->count == expr->capacity) {
+        size_t              capacity = expr->capacity > 0 ? 2 * expr->capacity : 16;
+        bigint_expr_item_t* items    = realloc(expr->items, capacity * sizeof(bigint_expr_item_t));
+
+        if (items == NULL) {
+            return BIGINT_EXPR_NONE;
+        }
+
+        expr->items    = items;
+        expr->capacity = capacity;
+    }
+
+    bigint_expr_item_t* item = &expr->items[expr->count];
+    memset(item, 0, sizeof(*item));
+    item->op    = op;
+    item->left  = left;
+    item->right = right;
+
+    return expr->count++;
+}
+
+bigint_expr_node_t bigint_expr_leaf(bigint_expr_t* expr, bigint_t* number)
+{
+    bigint_expr_node_t node = bigint_expr_push(expr, BIGINT_EXPR_LEAF, 0, 0);
+
+    if (node != BIGINT_EXPR_NONE) {
+        expr->items[node].leaf = number;
+    }
+    return node;
+}
+
+bigint_expr_node_t bigint_expr_u32(bigint_expr_t* expr, uint32_t value)
+{
+    bigint_expr_node_t node = bigint_expr_push(expr, BIGINT_EXPR_U32, 0, 0);
+
+    if (node != BIGINT_EXPR_NONE) {
+        expr->items[node].value = value;
+    }
+    return node;
+}
+
+bigint_expr_node_t bigint_expr_add(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b)
+{
+    return bigint_expr_push(expr, BIGINT_EXPR_ADD, a, b);
+}
+
+bigint_expr_node_t bigint_expr_sub(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b)
+{
+    return bigint_expr_push(expr, BIGINT_EXPR_SUB, a, b);
+}
+
+bigint_expr_node_t bigint_expr_mul(bigint_expr_t* expr, bigint_expr_node_t a, bigint_expr_node_t b)
+{
+    return bigint_expr_push(expr, BIGINT_EXPR_MUL, a, b);
+}
+
+// Values are magnitudes with a sign, most significant limb first and without
+// leading zeroes. They point into a leaf, a node or the scratch stack.
+typedef struct bigint_expr_value_s
+{
+    const uint32_t* limbs;
+    size_t          size;
+    bool            negative;
+} bigint_expr_value_t;
+
+// The scratch frame is used as a stack: whatever is taken above a mark is
+// given back by resetting the top to it.
+static uint32_t* bigint_expr_take(bigint_expr_t* expr, size_t* top, size_t n)
+{
+    uint32_t* limbs = expr->scratch + *top;
+    *top += n;
+    return limbs;
+}
+
+static void bigint_expr_negate(uint32_t* a, size_t n)
+{
+    uint32_t carry = 1;
+
+    for (size_t i = n; i > 0; i--) {
+        uint32_t x = ~a[i - 1] + carry;
+        carry    = carry && x == 0;
+        a[i - 1] = x;
+    }
+}
+
+static bigint_expr_value_t bigint_expr_trimmed(uint32_t* limbs, size_t n, bool negative)
+{
+    size_t zeros = limb_leading_zeros(limbs, n);
+    return (bigint_expr_value_t) { limbs + zeros, n - zeros, negative && zeros < n };
+}
+
+static void bigint_expr_accumulate(bigint_expr_t* expr, size_t* top, uint32_t* acc, size_t w, bigint_expr_node_t node, bool subtract);
+
+static bigint_expr_value_t bigint_expr_value(bigint_expr_t* expr, size_t* top, bigint_expr_node_t node)
+{
+    bigint_expr_item_t* item = &expr->items[node];
+
+    if (item->limbs != NULL) {
+        return (bigint_expr_value_t) { item->limbs, item->size, item->negative };
+    }
+
+    switch (item->op) {
+        case BIGINT_EXPR_LEAF: {
+            bigint_expr_value_t v = { NULL, 0, false };
+            v.limbs = bigint_limbs(item->leaf, &v.size);
+            return v;
+        }
+
+        case BIGINT_EXPR_U32:
+            return (bigint_expr_value_t) { &item->value, item->value != 0, false };
+
+        case BIGINT_EXPR_MUL: {
+            // Taken before anything the operands need, so it outlives them.
+            uint32_t*           r    = bigint_expr_take(expr, top, item->bound);
+            size_t              mark = *top;
+            bigint_expr_value_t x    = bigint_expr_value(expr, top, item->left);
+            bigint_expr_value_t y    = bigint_expr_value(expr, top, item->right);
+            size_t              n    = 0;
+
+            if (x.size > 0 && y.size > 0) {
+                uint32_t* scratch = bigint_expr_take(expr, top, limb_mul_scratch(MAX(x.size, y.size)));
+                n = x.size + y.size;
+                limb_mul(r, x.limbs, x.size, y.limbs, y.size, scratch);
+            }
+
+            *top = mark;
+            return bigint_expr_trimmed(r, n, x.negative != y.negative);
+        }
+
+        default: {
+            // A sum, in two's complement with a limb to spare for the sign.
+            size_t    w    = item->bound + 1;
+            uint32_t* acc  = bigint_expr_take(expr, top, w);
+            size_t    mark = *top;
+
+            memset(acc, 0, w * sizeof(uint32_t));
+            bigint_expr_accumulate(expr, top, acc, w, node, false);
+            *top = mark;
+
+            bool negative = acc[0] >> 31;
+            if (negative) {
+                bigint_expr_negate(acc, w);
+            }
+            return bigint_expr_trimmed(acc, w, negative);
+        }
+    }
+}
+
+static void bigint_expr_add_to(uint32_t* acc, size_t w, const uint32_t* a, size_t n, bool subtract)
+{
+    if (subtract) {
+        limb_sub(acc, acc, w, a, n);
+    } else {
+        limb_add(acc, acc, w, a, n);
+    }
+}
+
+// acc[w] += node or -= node, modulo B^w. Every term fits in fewer than w
+// limbs, see bigint_expr_eval.
+static void bigint_expr_accumulate(bigint_expr_t* expr, size_t* top, uint32_t* acc, size_t w, bigint_expr_node_t node, bool subtract)
+{
+    bigint_expr_item_t* item = &expr->items[node];
+    size_t              mark = *top;
+
+    // Sums nested in a sum just add their terms, unless computed already.
+    if (item->limbs == NULL && (item->op == BIGINT_EXPR_ADD || item->op == BIGINT_EXPR_SUB)) {
+        bigint_expr_accumulate(expr, top, acc, w, item->left, subtract);
+        bigint_expr_accumulate(expr, top, acc, w, item->right, subtract != (item->op == BIGINT_EXPR_SUB));
+        return;
+    }
+
+    if (item->limbs == NULL && item->op == BIGINT_EXPR_MUL) {
+        bigint_expr_value_t x = bigint_expr_value(expr, top, item->left);
+        bigint_expr_value_t y = bigint_expr_value(expr, top, item->right);
+
+        subtract = subtract != (x.negative != y.negative);
+
+        if (x.size == 0 || y.size == 0) {
+            // Nothing to add.
+
+        } else if (x.size == 1 || y.size == 1) {
+            // Fused, the product never exists on its own.
+            bigint_expr_value_t v = x.size == 1 ? y : x;
+            uint32_t            k = x.size == 1 ? x.limbs[0] : y.limbs[0];
+            uint32_t            carry;
+
+            if (subtract) {
+                carry = limb_submul_1(acc + w - v.size, v.limbs, v.size, k);
+            } else {
+                carry = limb_addmul_1(acc + w - v.size, v.limbs, v.size, k);
+            }
+            bigint_expr_add_to(acc, w - v.size, &carry, 1, subtract);
+
+        } else {
+            size_t    n       = x.size + y.size;
+            uint32_t* product = bigint_expr_take(expr, top, n);
+            uint32_t* scratch = bigint_expr_take(expr, top, limb_mul_scratch(MAX(x.size, y.size)));
+
+            limb_mul(product, x.limbs, x.size, y.limbs, y.size, scratch);
+            bigint_expr_add_to(acc, w, product, n, subtract);
+        }
+
+        *top = mark;
+        return;
+    }
+
+    bigint_expr_value_t v = bigint_expr_value(expr, top, node);
+    if (v.size > 0) {
+        bigint_expr_add_to(acc, w, v.limbs, v.size, subtract != v.negative);
+    }
+    *top = mark;
+}
+
+bool bigint_expr_eval(bigint_expr_t* expr, bigint_t* result, bigint_expr_node_t root)
+{
+    if (root >= expr->count) {
+        return false;
+    }
+
+    bigint_expr_item_t* items = expr->items;
+
+    // Count the uses of everything reachable from the root, parents come
+    // after their children.
+    for (size_t i = 0; i <= root; i++) {
+        items[i].uses  = 0;
+        items[i].limbs = NULL;
+    }
+    items[root].uses = 1;
+
+    for (size_t i = root + 1; i-- > 0;) {
+        if (items[i].uses > 0 && items[i].op >= BIGINT_EXPR_ADD) {
+            items[items[i].left].uses++;
+            items[items[i].right].uses++;
+        }
+    }
+
+    // Bounds on every magnitude, and on the scratch needed if every node
+    // took its share at once. A sum's bound covers all its partial sums: its
+    // terms are below B^bound(term) and there are fewer than B of them.
+    size_t needed = 0;
+
+    for (size_t i = 0; i <= root; i++) {
+        bigint_expr_item_t* item = &items[i];
+
+        if (item->uses == 0) {
+            continue;
+        }
+
+        switch (item->op) {
+            case BIGINT_EXPR_LEAF:
+                bigint_limbs(item->leaf, &item->bound);
+                break;
+
+            case BIGINT_EXPR_U32:
+                item->bound = 1;
+                break;
+
+            case BIGINT_EXPR_MUL:
+                item->bound = items[item->left].bound + items[item->right].bound;
+                needed     += item->bound + limb_mul_scratch(MAX(items[item->left].bound, items[item->right].bound));
+                break;
+
+            default:
+                item->bound = MAX(items[item->left].bound, items[item->right].bound) + 1;
+                needed     += item->bound + 1;
+                break;
+        }
+    }
+
+    // Never NULL, that would make every value look uncomputed.
+    scratch_frame_t frame;
+    expr->scratch = scratch_push(&frame, needed);
+
+    if (expr->scratch == NULL) {
+        return false;
+    }
+
+    // Shared nodes first, at the bottom of the stack where they stay put.
+    size_t top = 0;
+
+    for (size_t i = 0; i < root; i++) {
+        if (items[i].uses > 1 && items[i].op >= BIGINT_EXPR_ADD) {
+            bigint_expr_value_t v = bigint_expr_value(expr, &top, i);
+
+            items[i].limbs    = v.limbs;
+            items[i].size     = v.size;
+            items[i].negative = v.negative;
+        }
+    }
+
+    bigint_expr_value_t v  = bigint_expr_value(expr, &top, root);
+    bool                ok = !v.negative;
+
+    if (ok && items[root].op == BIGINT_EXPR_LEAF) {
+        // v points into the leaf, which may be the result itself.
+        ok = bigint_copy(result, items[root].leaf) && bigint_trim(result);
+
+    } else if (ok) {
+        bigint_t view;
+        bigint_wrap(&view, v.limbs, v.size);
+
+        ok = bigint_copy(result, &view);
+        bigint_release(&view);
+    }
+
+    scratch_pop(&frame);
+    expr->scratch = NULL;
+    return ok;
+}
@@ -0,0 +1,248 @@
+#include "bigint_file.h"
+
+#include<fcntl.h>
+#include<string.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#define BIGINT_FILE_BYTE_ORDER 0x01020304u
+#define BIGINT_FILE_SWAPPED    0x04030201u
+
+#define FNV_OFFSET 0xCBF29CE484222325ull
+#define FNV_PRIME  0x00000100000001B3ull
+
+// FNV-1a over whole limb values rather than bytes, so the checksum does not
+// depend on the byte order the file was written in.
+static uint64_t bigint_file_checksum(uint64_t hash, const uint32_t* limbs, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        hash ^= limbs[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool bigint_file_write_all(int fd, const void* data, size_t size)
+{
+    const uint8_t* bytes = data;
+
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size  -= (size_t) written;
+    }
+
+    return true;
+}
+
+static bool bigint_file_read_all(int fd, void* data, size_t size)
+{
+    uint8_t* bytes = data;
+
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size  -= (size_t) got;
+    }
+
+    return true;
+}
+
+static void bigint_file_header_init(bigint_file_header_t* header, uint64_t count, uint64_t checksum)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, BIGINT_FILE_MAGIC, sizeof(header->magic));
+    header->version    = BIGINT_FILE_VERSION;
+    header->byte_order = BIGINT_FILE_BYTE_ORDER;
+    header->limb_bits  = 32;
+    header->limb_order = 1;
+    header->count      = count;
+    header->checksum   = checksum;
+}
+
+// Validates the header, fixing its fields up if it comes from a machine with
+// the other byte order. Sets *swapped accordingly.
+static bool bigint_file_header_check(bigint_file_header_t* header, bool* swapped)
+{
+    if (memcmp(header->magic, BIGINT_FILE_MAGIC, sizeof(header->magic)) != 0) {
+        return false;
+    }
+
+    *swapped = header->byte_order == BIGINT_FILE_SWAPPED;
+
+    if (*swapped) {
+        header->version    = __builtin_bswap32(header->version);
+        header->byte_order = __builtin_bswap32(header->byte_order);
+        header->limb_bits  = __builtin_bswap32(header->limb_bits);
+        header->limb_order = __builtin_bswap32(header->limb_order);
+        header->count      = __builtin_bswap64(header->count);
+        header->checksum   = __builtin_bswap64(header->checksum);
+    }
+
+    return header->version    == BIGINT_FILE_VERSION
+        && header->byte_order == BIGINT_FILE_BYTE_ORDER
+        && header->limb_bits  == 32
+        && header->limb_order == 1;
+}
+
+bool bigint_writer_open(bigint_writer_t* writer, int fd)
+{
+    bigint_file_header_t header;
+
+    writer->fd       = fd;
+    writer->count    = 0;
+    writer->checksum = FNV_OFFSET;
+
+    // Placeholder, the real count and checksum are only known on close.
+    bigint_file_header_init(&header, 0, 0);
+    return bigint_file_write_all(fd, &header, sizeof(header));
+}
+
+bool bigint_writer_append(bigint_writer_t* writer, const uint32_t* limbs, size_t count)
+{
+    if (!bigint_file_write_all(writer->fd, limbs, count * sizeof(uint32_t))) {
+        return false;
+    }
+
+    writer->count   += count;
+    writer->checksum = bigint_file_checksum(writer->checksum, limbs, count);
+    return true;
+}
+
+bool bigint_writer_close(bigint_writer_t* writer)
+{
+    bigint_file_header_t header;
+    bigint_file_header_init(&header, writer->count, writer->checksum);
+
+    return pwrite(writer->fd, &header, sizeof(header), 0) == (ssize_t) sizeof(header);
+}
+
+bool bigint_file_save(const char* path, bigint_t* number)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t          count;
+    const uint32_t* limbs = bigint_limbs(number, &count);
+    bigint_writer_t writer;
+
+    bool ok = bigint_writer_open(&writer, fd)
+           && bigint_writer_append(&writer, limbs, count)
+           && bigint_writer_close(&writer);
+
+    return close(fd) == 0 && ok;
+}
+
+bool bigint_file_map(bigint_map_t* map, const char* path, bool verify)
+{
+    struct stat st;
+    bool        swapped;
+
+    memset(map, 0, sizeof(*map));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(bigint_file_header_t)) {
+        close(fd);
+        return false;
+    }
+
+    size_t length = (size_t) st.st_size;
+    void*  base   = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    bigint_file_header_t header;
+    memcpy(&header, base, sizeof(header));
+
+    const uint32_t* limbs = (const uint32_t*) ((uint8_t*) base + sizeof(header));
+
+    // Foreign byte order can't be used in place, see bigint_file_load.
+    if (!bigint_file_header_check(&header, &swapped) || swapped
+        || header.count > (length - sizeof(header)) / sizeof(uint32_t)
+        || (verify && bigint_file_checksum(FNV_OFFSET, limbs, header.count) != header.checksum)) {
+        munmap(base, length);
+        return false;
+    }
+
+    map->base   = base;
+    map->length = length;
+    bigint_wrap(&map->number, limbs, header.count);
+    return true;
+}
+
+void bigint_file_unmap(bigint_map_t* map)
+{
+    bigint_release(&map->number);
+
+    if (map->base != NULL) {
+        munmap(map->base, map->length);
+    }
+
+    map->base   = NULL;
+    map->length = 0;
+}
+
+bool bigint_file_load(bigint_t* number, const char* path)
+{
+    bigint_file_header_t header;
+    struct stat          st;
+    bool                 swapped;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Loaded on the side, number is only replaced once the checksum matches.
+    bigint_t* loaded = bigint_new();
+
+    // The count comes from the file, nothing is allocated for it before it
+    // agrees with the file's length.
+    bool ok = loaded != NULL
+           && fstat(fd, &st) == 0
+           && bigint_file_read_all(fd, &header, sizeof(header))
+           && bigint_file_header_check(&header, &swapped)
+           && header.count <= SIZE_MAX / sizeof(uint32_t)
+           && (uint64_t) st.st_size == sizeof(header) + header.count * sizeof(uint32_t)
+           && ARRAY_RESIZE_R(loaded, header.count)
+           && bigint_file_read_all(fd, loaded->items, header.count * sizeof(uint32_t));
+
+    close(fd);
+
+    if (ok) {
+        uint32_t* limbs = (uint32_t*) loaded->items;
+
+        if (swapped) {
+            for (size_t i = 0; i < header.count; i++) {
+                limbs[i] = __builtin_bswap32(limbs[i]);
+            }
+        }
+
+        ok = bigint_file_checksum(FNV_OFFSET, limbs, header.count) == header.checksum;
+    }
+
+    if (ok) {
+        bigint_swap(number, loaded);
+    }
+
+    if (loaded != NULL) {
+        bigint_delete(loaded);
+    }
+    return ok;
+}
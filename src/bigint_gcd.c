@@ -0,0 +1,499 @@
+#include "bigint_gcd.h"
+#include "bigint_tune.h"
+#include "limb.h"
+#include "stats.h"
+
+// Bits of u and v looked at by each Lehmer step. Leaves room for the
+// cofactors in int64_t arithmetic.
+#define BIGINT_LEHMER_BITS 62
+
+// Bits of its top part a half-GCD step leaves unreduced on top of half, so
+// that the errors from the bits cut off stay far below the remainders.
+#define BIGINT_HALF_MARGIN 64
+
+// Remainder sequence u, v with rows of cofactors. Every row (c0, c1) takes the
+// same steps, starting from (1, 0) it follows the cofactor of a. Cofactors are
+// kept as magnitudes: their signs alternate along the sequence, so only the
+// parity of the number of steps taken is needed.
+typedef struct bigint_gcd_s
+{
+    bigint_t* u;
+    bigint_t* v;
+    bigint_t* s[2][2];
+    bigint_t* t;
+    bigint_t* w;
+    bool      odd;
+    size_t    rows;
+} bigint_gcd_t;
+
+static uint64_t bigint_gcd_u64(uint64_t a, uint64_t b)
+{
+    if (a == 0 || b == 0) {
+        return a | b;
+    }
+
+    // Binary GCD, stripping trailing zeroes in one go.
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+
+    while (b != 0) {
+        b >>= __builtin_ctzll(b);
+        if (a > b) {
+            uint64_t tmp = a;
+            a = b;
+            b = tmp;
+        }
+        b -= a;
+    }
+
+    return a << shift;
+}
+
+// (x >> shift) truncated to 64 bits.
+static uint64_t bigint_gcd_bits(bigint_t* x, size_t shift)
+{
+    size_t            xn;
+    const uint32_t*   xl   = bigint_limbs(x, &xn);
+    size_t            limb = shift / 32;
+    unsigned __int128 acc  = 0;
+
+    for (size_t i = 3; i > 0; i--) {
+        size_t index = limb + i - 1;
+        acc <<= 32;
+        if (index < xn) {
+            acc |= xl[xn - 1 - index];
+        }
+    }
+
+    return (uint64_t) (acc >> (shift % 32));
+}
+
+// One step of Euclid: u, v = v, u mod v.
+static bool bigint_gcd_euclid(bigint_gcd_t* st)
+{
+    if (!bigint_divmod(st->t, st->w, st->u, st->v)) {
+        return false;
+    }
+
+    bigint_swap(st->u, st->v);
+    bigint_swap(st->v, st->w);
+
+    // c0, c1 = c1, c0 + q * c1
+    for (size_t i = 0; i < st->rows; i++) {
+        bigint_t** c = st->s[i];
+
+        if (!bigint_mul(st->w, st->t, c[1]) || !bigint_add(st->w, st->w, c[0])) {
+            return false;
+        }
+
+        bigint_swap(c[0], c[1]);
+        bigint_swap(c[1], st->w);
+    }
+
+    st->odd = !st->odd;
+    return true;
+}
+
+// r[n] = p * x[n] - q * y[n], known to be non negative and to fit.
+static void bigint_gcd_combine(uint32_t* r, const uint32_t* x, uint32_t p, const uint32_t* y, uint32_t q, size_t n)
+{
+    limb_mul_1(r, x, n, p);
+    limb_submul_1(r, y, n, q);
+}
+
+static uint32_t bigint_gcd_abs(int64_t x)
+{
+    return (uint32_t) (x < 0 ? -x : x);
+}
+
+// c0, c1 = a * c0 + b * c1, c * c0 + d * c1. Leaves room for the carries
+// rather than trimming at every step.
+static bool bigint_gcd_row(bigint_gcd_t* st, bigint_t** c, uint32_t a, uint32_t b, uint32_t cc, uint32_t d)
+{
+    size_t c0n, c1n;
+    bigint_limbs(c[0], &c0n);
+    bigint_limbs(c[1], &c1n);
+
+    size_t n = MAX(c0n, c1n) + 2;
+
+    if (!ARRAY_RESIZE_R(c[0], n) || !bigint_unshare(c[0]) || !ARRAY_RESIZE_R(c[1], n) || !bigint_unshare(c[1])
+        || !ARRAY_RESIZE_R(st->t, n) || !bigint_unshare(st->t)
+        || !ARRAY_RESIZE_R(st->w, n) || !bigint_unshare(st->w)) {
+        return false;
+    }
+
+    const uint32_t* c0 = (const uint32_t*) c[0]->items;
+    const uint32_t* c1 = (const uint32_t*) c[1]->items;
+    uint32_t*       t  = (uint32_t*) st->t->items;
+    uint32_t*       w  = (uint32_t*) st->w->items;
+
+    limb_mul_1(t, c0, n, a);
+    limb_addmul_1(t, c1, n, b);
+    limb_mul_1(w, c0, n, cc);
+    limb_addmul_1(w, c1, n, d);
+
+    bigint_swap(c[0], st->t);
+    bigint_swap(c[1], st->w);
+    return true;
+}
+
+// Lehmer's step: runs Euclid on the leading bits of u and v only, for as long
+// as the quotients are certain to match the real ones, then applies all of
+// them at once as a 2x2 matrix. Falls back to a full Euclid step when not even
+// the first quotient is certain.
+static bool bigint_gcd_lehmer(bigint_gcd_t* st)
+{
+    size_t   bits  = bigint_bitlen(st->u);
+    size_t   shift = bits - BIGINT_LEHMER_BITS;
+    int64_t  x     = (int64_t) bigint_gcd_bits(st->u, shift);
+    int64_t  y     = (int64_t) bigint_gcd_bits(st->v, shift);
+    int64_t  A = 1, B = 0, C = 0, D = 1;
+    unsigned steps = 0;
+
+    while (y + C != 0 && y + D != 0) {
+        int64_t q = (x + A) / (y + C);
+        if (q != (x + B) / (y + D)) {
+            break;
+        }
+
+        // Cofactors have to fit the 32 bit multipliers below.
+        __int128 nc = (__int128) A - (__int128) q * C;
+        __int128 nd = (__int128) B - (__int128) q * D;
+        if (nc <= -(__int128) UINT32_MAX || nc >= UINT32_MAX || nd <= -(__int128) UINT32_MAX || nd >= UINT32_MAX) {
+            break;
+        }
+
+        int64_t r = x - q * y;
+
+        A = C;
+        C = (int64_t) nc;
+        B = D;
+        D = (int64_t) nd;
+        x = y;
+        y = r;
+        steps++;
+    }
+
+    if (B == 0) {
+        return bigint_gcd_euclid(st);
+    }
+
+    // Each row has one entry <= 0 and the other >= 0.
+    size_t n;
+    bigint_limbs(st->u, &n);
+
+    if (!bigint_trim(st->u) || !bigint_resize(st->v, n) || !bigint_unshare(st->v)
+        || !ARRAY_RESIZE_R(st->t, n) || !bigint_unshare(st->t)
+        || !ARRAY_RESIZE_R(st->w, n) || !bigint_unshare(st->w)) {
+        return false;
+    }
+
+    const uint32_t* u = (const uint32_t*) st->u->items;
+    const uint32_t* v = (const uint32_t*) st->v->items + (st->v->size - n);
+
+    if (B < 0) {
+        bigint_gcd_combine((uint32_t*) st->t->items, u, bigint_gcd_abs(A), v, bigint_gcd_abs(B), n);
+    } else {
+        bigint_gcd_combine((uint32_t*) st->t->items, v, bigint_gcd_abs(B), u, bigint_gcd_abs(A), n);
+    }
+
+    if (C <= 0) {
+        bigint_gcd_combine((uint32_t*) st->w->items, v, bigint_gcd_abs(D), u, bigint_gcd_abs(C), n);
+    } else {
+        bigint_gcd_combine((uint32_t*) st->w->items, u, bigint_gcd_abs(C), v, bigint_gcd_abs(D), n);
+    }
+
+    bigint_swap(st->u, st->t);
+    bigint_swap(st->v, st->w);
+
+    if (!bigint_trim(st->u) || !bigint_trim(st->v)) {
+        return false;
+    }
+
+    // Same matrix on the cofactor magnitudes, where both terms always add up.
+    bool ok = true;
+
+    for (size_t i = 0; ok && i < st->rows; i++) {
+        ok = bigint_gcd_row(st, st->s[i], bigint_gcd_abs(A), bigint_gcd_abs(B), bigint_gcd_abs(C), bigint_gcd_abs(D));
+    }
+
+    st->odd ^= steps & 1;
+    return ok;
+}
+
+static bool bigint_gcd_init(bigint_gcd_t* st, bigint_t* a, bigint_t* b, size_t rows)
+{
+    bool ok = true;
+
+    st->u    = bigint_new();
+    st->v    = bigint_new();
+    st->t    = bigint_new();
+    st->w    = bigint_new();
+    st->odd  = false;
+    st->rows = rows;
+
+    // Rows start as the identity.
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            st->s[i][j] = i < rows ? bigint_new() : NULL;
+            ok = ok && (i >= rows || (st->s[i][j] != NULL && bigint_set_u32(st->s[i][j], i == j)));
+        }
+    }
+
+    return ok && st->u != NULL && st->v != NULL && st->t != NULL && st->w != NULL
+        && bigint_copy(st->u, a) && bigint_copy(st->v, b);
+}
+
+static void bigint_gcd_free(bigint_gcd_t* st)
+{
+    bigint_t* all[8] = { st->u, st->v, st->t, st->w, st->s[0][0], st->s[0][1], st->s[1][0], st->s[1][1] };
+
+    for (size_t i = 0; i < 8; i++) {
+        if (all[i] != NULL) {
+            bigint_delete(all[i]);
+        }
+    }
+}
+
+static bool bigint_gcd_run(bigint_gcd_t* st, size_t stop);
+
+// r = (r << bits) + a * x - b * y, with the products the other way around
+// when negate. Clears valid instead when that would be negative.
+static bool bigint_gcd_lift(bigint_gcd_t* top, bigint_t* r, size_t bits, bigint_t* a, bigint_t* x, bigint_t* b, bigint_t* y,
+                            bool negate, bool* valid)
+{
+    if (!bigint_shl(r, r, bits) || !bigint_mul(top->t, a, x) || !bigint_mul(top->w, b, y)) {
+        return false;
+    }
+
+    if (negate) {
+        bigint_swap(top->t, top->w);
+    }
+
+    if (!bigint_add(r, r, top->t)) {
+        return false;
+    }
+
+    if (bigint_cmp(r, top->w) < 0) {
+        *valid = false;
+        return true;
+    }
+    return bigint_sub(r, r, top->w);
+}
+
+// Half-GCD step: runs the sequence on the top k bits of u and v down to about
+// k / 2 bits, recursively, which gives the quotients for the full numbers as
+// long as the cofactors stay well below the remainders. The steps taken there
+// are then lifted to the full numbers at once, multiplying the bits below the
+// top part only.
+//
+// A matrix M of quotients q >= 1 with (u, v) = M (u', v') and u' > v' >= 0 is
+// the start of the sequence of u, v. Anything else means the top part was cut
+// too short, which only adversarial inputs come near, and a Lehmer step is
+// taken instead. Returns false when out of memory only.
+static bool bigint_gcd_half(bigint_gcd_t* st, size_t stop, bool* taken)
+{
+    size_t n = bigint_bitlen(st->u);
+    size_t h = n - stop;
+    size_t k = 2 * h < n / 2 ? 2 * h : n / 2;
+
+    *taken = false;
+    if (k < 4 * BIGINT_HALF_MARGIN) {
+        return true;
+    }
+
+    // Cut on a limb boundary, so the parts are views of u and v.
+    size_t p = (n - k) / 32;
+    k = n - 32 * p;
+
+    // v much shorter than u, a single quotient goes further than any.
+    if (bigint_bitlen(st->v) <= 32 * p + k / 2 + BIGINT_HALF_MARGIN) {
+        return true;
+    }
+
+    size_t          un, vn;
+    const uint32_t* ul = bigint_limbs(st->u, &un);
+    const uint32_t* vl = bigint_limbs(st->v, &vn);
+    bigint_t        uhi, ulo, vhi, vlo;
+
+    bigint_wrap(&uhi, ul, un - p);
+    bigint_wrap(&ulo, ul + un - p, p);
+    bigint_wrap(&vhi, vl, vn - p);
+    bigint_wrap(&vlo, vl + vn - p, p);
+
+    bigint_gcd_t top;
+    bool         valid = true;
+    bool         ok    = bigint_gcd_init(&top, &uhi, &vhi, 2)
+                      && bigint_gcd_run(&top, k / 2 + BIGINT_HALF_MARGIN);
+
+    // The rows are (m11, m10) and (m01, m00) of M, whose determinant is -1
+    // after an odd number of steps:
+    //
+    //     u' = det * (m11 * u - m01 * v)
+    //     v' = det * (m00 * v - m10 * u)
+    //
+    // The top part of those is what top ended with.
+    ok = ok && bigint_gcd_lift(&top, top.u, 32 * p, top.s[0][0], &ulo, top.s[1][0], &vlo, top.odd, &valid)
+            && bigint_gcd_lift(&top, top.v, 32 * p, top.s[1][1], &vlo, top.s[0][1], &ulo, top.odd, &valid);
+
+    bigint_release(&uhi);
+    bigint_release(&ulo);
+    bigint_release(&vhi);
+    bigint_release(&vlo);
+
+    if (ok && valid && bigint_cmp(top.u, top.v) > 0) {
+        bigint_swap(st->u, top.u);
+        bigint_swap(st->v, top.v);
+
+        // (c0, c1) = (c0, c1) M', M' the rows of top.
+        for (size_t i = 0; ok && i < st->rows; i++) {
+            bigint_t** c = st->s[i];
+
+            ok = bigint_mul(st->t, c[0], top.s[0][0])
+              && bigint_mul(st->w, c[1], top.s[1][0])
+              && bigint_add(st->t, st->t, st->w)
+              && bigint_mul(st->w, c[0], top.s[0][1])
+              && bigint_mul(c[1], c[1], top.s[1][1])
+              && bigint_add(c[1], c[1], st->w);
+
+            bigint_swap(c[0], st->t);
+        }
+
+        st->odd ^= top.odd;
+        *taken   = true;
+    }
+
+    bigint_gcd_free(&top);
+    return ok;
+}
+
+// Takes steps until v is stop bits or shorter, 0 for the whole sequence.
+static bool bigint_gcd_run(bigint_gcd_t* st, size_t stop)
+{
+    bool ok = true;
+
+    while (ok && bigint_bitlen(st->v) > stop) {
+        bool taken = false;
+
+        if (st->rows == 0 && bigint_bitlen(st->u) <= 64 && bigint_bitlen(st->v) <= 64) {
+            // Both fit a word, finish with binary GCD.
+            BIGINT_COUNT(BIGINT_STAT_GCD_BINARY, st->u->size);
+            ok = bigint_set_u64(st->u, bigint_gcd_u64(bigint_get_u64(st->u), bigint_get_u64(st->v)))
+              && bigint_set_u32(st->v, 0);
+            continue;
+        }
+
+        if (bigint_cmp(st->u, st->v) < 0 || bigint_bitlen(st->u) <= BIGINT_LEHMER_BITS) {
+            BIGINT_COUNT(BIGINT_STAT_GCD_EUCLID, st->u->size);
+            ok = bigint_gcd_euclid(st);
+            continue;
+        }
+
+        if (st->u->size >= bigint_threshold_get(BIGINT_THRESHOLD_GCD_HALF)) {
+            ok = bigint_gcd_half(st, stop, &taken);
+            if (taken) {
+                BIGINT_COUNT(BIGINT_STAT_GCD_HALF, st->u->size);
+            }
+        }
+
+        if (ok && !taken) {
+            BIGINT_COUNT(BIGINT_STAT_GCD_LEHMER, st->u->size);
+            ok = bigint_gcd_lehmer(st);
+        }
+    }
+
+    for (size_t i = 0; ok && i < st->rows; i++) {
+        ok = bigint_trim(st->s[i][0]) && bigint_trim(st->s[i][1]);
+    }
+    return ok;
+}
+
+bool bigint_gcd(bigint_t* g, bigint_t* a, bigint_t* b)
+{
+    size_t an, bn;
+    bigint_limbs(a, &an);
+    bigint_limbs(b, &bn);
+
+    // Small operands go straight to binary GCD.
+    if (an <= 2 && bn <= 2) {
+        BIGINT_COUNT(BIGINT_STAT_GCD_BINARY, an + bn);
+        return bigint_set_u64(g, bigint_gcd_u64(bigint_get_u64(a), bigint_get_u64(b)));
+    }
+
+    bigint_gcd_t st;
+    bool ok = bigint_gcd_init(&st, a, b, 0);
+
+    if (ok) {
+        BIGINT_TIME_BEGIN(BIGINT_STAT_GCD, timer, an + bn);
+        ok = bigint_gcd_run(&st, 0);
+        BIGINT_TIME_END(timer);
+    }
+
+    if (ok) {
+        bigint_swap(g, st.u);
+    }
+
+    bigint_gcd_free(&st);
+    return ok;
+}
+
+bool bigint_gcdext(bigint_t* g, bigint_t* s, bigint_t* a, bigint_t* b)
+{
+    bigint_gcd_t st;
+    bool         ok = bigint_gcd_init(&st, a, b, 1);
+    bigint_t*    s0 = st.s[0][0];
+
+    if (ok) {
+        BIGINT_TIME_BEGIN(BIGINT_STAT_GCD, timer, a->size + b->size);
+        ok = bigint_gcd_run(&st, 0);
+        BIGINT_TIME_END(timer);
+    }
+
+    // s0 is positive after an even number of steps. Otherwise a * -s0 = g,
+    // and b / g - s0 is the representative we want.
+    if (ok && st.odd && !bigint_is_zero(s0)) {
+        ok = bigint_divmod(st.t, NULL, b, st.u)
+          && bigint_sub(s0, st.t, s0);
+    }
+
+    // gcd(0, 0) = 0, any cofactor works and GMP gives 0.
+    if (ok && bigint_is_zero(st.u)) {
+        ok = bigint_set_u32(s0, 0);
+    }
+
+    if (ok && s != NULL) {
+        bigint_swap(s, s0);
+    }
+    if (ok) {
+        bigint_swap(g, st.u);
+    }
+
+    bigint_gcd_free(&st);
+    return ok;
+}
+
+bool bigint_invert(bigint_t* result, bigint_t* a, bigint_t* m)
+{
+    if (bigint_is_zero(m)) {
+        return false;
+    }
+
+    bigint_t* g = bigint_new();
+    bigint_t* s = bigint_new();
+    bool      ok = g != NULL && s != NULL
+                && bigint_gcdext(g, s, a, m)
+                && bigint_bitlen(g) == 1;
+
+    // gcd(a, 1) is 1 but the only residue modulo 1 is 0.
+    if (ok) {
+        ok = bigint_bitlen(m) == 1 ? bigint_set_u32(result, 0) : bigint_copy(result, s);
+    }
+
+    if (g != NULL) {
+        bigint_delete(g);
+    }
+    if (s != NULL) {
+        bigint_delete(s);
+    }
+    return ok;
+}
@@ -0,0 +1,431 @@
+#include "bigint_io.h"
+#include "bigint_tune.h"
+#include "job.h"
+#include "limb.h"
+#include "scratch.h"
+#include "stats.h"
+
+#include<string.h>
+#include<unistd.h>
+
+#define BIGINT_IO_BUFFER 65536
+
+typedef struct bigint_sink_s bigint_sink_t;
+
+struct bigint_sink_s
+{
+    char*  buffer;
+    size_t used;
+    size_t capacity;
+    bool   ok;
+
+    bool (*flush)(bigint_sink_t* sink);
+    FILE* stream;
+    int   fd;
+};
+
+static bool bigint_sink_flush_stream(bigint_sink_t* sink)
+{
+    return fwrite(sink->buffer, 1, sink->used, sink->stream) == sink->used;
+}
+
+static bool bigint_sink_flush_fd(bigint_sink_t* sink)
+{
+    const char* data = sink->buffer;
+    size_t      left = sink->used;
+
+    while (left > 0) {
+        ssize_t written = write(sink->fd, data, left);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        left -= (size_t) written;
+    }
+
+    return true;
+}
+
+static void bigint_sink_put(bigint_sink_t* sink, const char* digits, size_t count)
+{
+    job_progress(JOB_WORK_DIGITS, count);
+
+    while (count > 0 && sink->ok) {
+        if (sink->used == sink->capacity) {
+            sink->ok   = sink->flush != NULL && sink->flush(sink);
+            sink->used = 0;
+            continue;
+        }
+
+        size_t room = sink->capacity - sink->used;
+        size_t take = count < room ? count : room;
+
+        memcpy(sink->buffer + sink->used, digits, take);
+        sink->used += take;
+        digits     += take;
+        count      -= take;
+    }
+}
+
+static void bigint_sink_zeroes(bigint_sink_t* sink, size_t count)
+{
+    static const char zeroes[64] = "0000000000000000000000000000000000000000000000000000000000000000";
+
+    while (count > 0) {
+        size_t take = count < sizeof(zeroes) ? count : sizeof(zeroes);
+        bigint_sink_put(sink, zeroes, take);
+        count -= take;
+    }
+}
+
+static const char bigint_digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+typedef struct bigint_radix_s
+{
+    unsigned   base;
+    unsigned   chunk_digits;  // Digits held by one chunk
+    uint32_t   chunk;         // base ^ chunk_digits, the largest that fits a limb
+    bigint_t** powers;        // powers[i] = chunk ^ (2 ^ i)
+    size_t     count;
+} bigint_radix_t;
+
+static bool bigint_radix_init(bigint_radix_t* radix, unsigned base, size_t limbs)
+{
+    radix->base         = base;
+    radix->chunk_digits = 1;
+    radix->chunk        = base;
+    radix->powers       = NULL;
+    radix->count        = 0;
+
+    while ((uint64_t) radix->chunk * base <= 0xFFFFFFFFu) {
+        radix->chunk *= base;
+        radix->chunk_digits++;
+    }
+
+    // Only powers up to about half the number are ever divided by.
+    size_t max_count = 1;
+    for (size_t bits = 32; bits < limbs * 32; bits *= 2) {
+        max_count++;
+    }
+
+    radix->powers = calloc(max_count, sizeof(bigint_t*));
+    if (radix->powers == NULL) {
+        return false;
+    }
+
+    while (radix->count < max_count) {
+        bigint_t* power = bigint_new();
+        if (power == NULL) {
+            return false;
+        }
+        radix->powers[radix->count++] = power;
+
+        bool ok = radix->count == 1
+                ? bigint_set_u32(power, radix->chunk)
+                : bigint_mul(power, radix->powers[radix->count - 2], radix->powers[radix->count - 2]);
+
+        if (!ok) {
+            return false;
+        }
+
+        if (power->size * 2 > limbs + 1) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+static void bigint_radix_free(bigint_radix_t* radix)
+{
+    for (size_t i = 0; i < radix->count; i++) {
+        bigint_delete(radix->powers[i]);
+    }
+    free(radix->powers);
+}
+
+// Largest power that is at most about half as long as a, 0 when a is
+// converted by bigint_radix_basecase.
+static size_t bigint_radix_level(bigint_radix_t* radix, size_t an)
+{
+    size_t k = radix->count;
+    while (k > 0 && radix->powers[k - 1]->size * 2 > an + 1) {
+        k--;
+    }
+
+    return an < bigint_threshold_get(BIGINT_THRESHOLD_RADIX_DC) ? 0 : k;
+}
+
+// Each chunk takes at least 26 bits off, so this is enough room for them.
+#define BIGINT_RADIX_CHUNKS(an) ((an) + (an) / 4 + 1)
+
+// Scratch for converting an limbs, mirroring bigint_radix_convert down the
+// quotient side, the longer one. Leading zeroes can make a level take more,
+// it then pushes a frame of its own.
+static size_t bigint_radix_scratch(bigint_radix_t* radix, size_t an)
+{
+    size_t k = bigint_radix_level(radix, an);
+
+    if (k == 0) {
+        return an + BIGINT_RADIX_CHUNKS(an);
+    }
+
+    size_t pn = radix->powers[k - 1]->size;
+    size_t qn = an - pn + 1;
+
+    // A single limb divisor only shortens the quotient by dividing, count
+    // the basecase below it.
+    size_t below = qn < an ? bigint_radix_scratch(radix, qn) : qn + BIGINT_RADIX_CHUNKS(qn);
+
+    return qn + pn + MAX(limb_divmod_scratch(an, pn), below);
+}
+
+// Peels chunks off the right end with single limb divisions, then writes
+// them out left to right, padded to `pad` digits.
+static void bigint_radix_basecase(bigint_radix_t* radix, bigint_sink_t* sink, const uint32_t* a, size_t an, size_t pad, uint32_t* work)
+{
+    uint32_t* chunks = work + an;
+    size_t    count  = 0;
+
+    memcpy(work, a, an * sizeof(uint32_t));
+
+    for (uint32_t* t = work; an > 0; ) {
+        chunks[count++] = limb_divmod_1(t, t, an, radix->chunk);
+        if (t[0] == 0) {
+            t++;
+            an--;
+        }
+    }
+
+    char   digits[32];
+    size_t total = 0;
+
+    // Only the leading chunk isn't padded to chunk_digits.
+    if (count > 0) {
+        for (uint32_t top = chunks[count - 1]; top > 0; top /= radix->base) {
+            total++;
+        }
+        total += (count - 1) * radix->chunk_digits;
+    }
+
+    if (pad > total) {
+        bigint_sink_zeroes(sink, pad - total);
+    }
+
+    for (size_t c = count; c-- > 0;) {
+        uint32_t value = chunks[c];
+        size_t   width = radix->chunk_digits;
+
+        if (c == count - 1) {
+            width = 0;
+            for (uint32_t top = value; top > 0; top /= radix->base) {
+                width++;
+            }
+        }
+
+        for (size_t i = width; i > 0; i--) {
+            digits[i - 1] = bigint_digits[value % radix->base];
+            value        /= radix->base;
+        }
+
+        bigint_sink_put(sink, digits, width);
+    }
+}
+
+// scratch holds sn limbs, bigint_radix_scratch(radix, an) unless it's short.
+static bool bigint_radix_convert(bigint_radix_t* radix, bigint_sink_t* sink, const uint32_t* a, size_t an, size_t pad, uint32_t* scratch, size_t sn)
+{
+    size_t zeros = limb_leading_zeros(a, an);
+    a  += zeros;
+    an -= zeros;
+
+    size_t need = bigint_radix_scratch(radix, an);
+
+    if (need > sn) {
+        scratch_frame_t frame;
+        uint32_t*       more = scratch_push(&frame, need);
+        bool            ok   = more != NULL && bigint_radix_convert(radix, sink, a, an, pad, more, need);
+
+        scratch_pop(&frame);
+        return ok;
+    }
+
+    if (job_cancelled()) {
+        return false;
+    }
+
+    // Below the threshold, digits are peeled off one chunk at a time.
+    size_t k = bigint_radix_level(radix, an);
+
+    if (k == 0) {
+        BIGINT_COUNT(BIGINT_STAT_RADIX_BASECASE, an);
+        bigint_radix_basecase(radix, sink, a, an, pad, scratch);
+        return sink->ok;
+    }
+
+    bigint_t*       power = radix->powers[k - 1];
+    const uint32_t* pl    = (const uint32_t*) power->items;
+    size_t          pn    = power->size;
+    size_t          qn    = an - pn + 1;
+    size_t          low   = (size_t) radix->chunk_digits << (k - 1);
+
+    BIGINT_COUNT(BIGINT_STAT_RADIX_DC, an);
+
+    // The quotient and remainder stay put while both halves are converted
+    // in the space after them.
+    uint32_t* q    = scratch;
+    uint32_t* r    = q + qn;
+    uint32_t* next = r + pn;
+
+    limb_divmod(q, r, a, an, pl, pn, next);
+
+    return bigint_radix_convert(radix, sink, q, qn, pad > low ? pad - low : 0, next, sn - qn - pn)
+        && bigint_radix_convert(radix, sink, r, pn, low, next, sn - qn - pn);
+}
+
+static bool bigint_write_sink(bigint_sink_t* sink, bigint_t* number, unsigned base)
+{
+    size_t          an;
+    const uint32_t* a = bigint_limbs(number, &an);
+
+    if (base < 2 || base > 36) {
+        return false;
+    }
+
+    if (an == 0) {
+        bigint_sink_put(sink, "0", 1);
+
+    } else if ((base & (base - 1)) == 0) {
+        // Power of two bases just read the bits, most significant first.
+        size_t bits   = (size_t) __builtin_ctz(base);
+        size_t bitlen = bigint_bitlen(number);
+        size_t count  = (bitlen + bits - 1) / bits;
+        char   digits[64];
+        size_t used   = 0;
+
+        // Put out a buffer at a time, like bigint_radix_basecase does.
+        for (size_t d = count; d-- > 0;) {
+            size_t   pos   = d * bits;
+            uint64_t value = a[an - 1 - pos / 32];
+
+            if (pos / 32 + 1 < an) {
+                value |= (uint64_t) a[an - 2 - pos / 32] << 32;
+            }
+
+            digits[used++] = bigint_digits[(value >> (pos % 32)) & (base - 1)];
+
+            if (used == sizeof(digits) || d == 0) {
+                bigint_sink_put(sink, digits, used);
+                used = 0;
+            }
+        }
+
+    } else {
+        bigint_radix_t radix;
+
+        // One frame for every level, sized before the first division.
+        scratch_frame_t frame;
+        size_t          sn      = 0;
+        uint32_t*       scratch = NULL;
+
+        bool ok = bigint_radix_init(&radix, base, an);
+
+        if (ok) {
+            sn      = bigint_radix_scratch(&radix, an);
+            scratch = scratch_push(&frame, sn);
+            ok      = scratch != NULL;
+        }
+
+        if (ok) {
+            BIGINT_TIME_BEGIN(BIGINT_STAT_RADIX, timer, an);
+            ok = bigint_radix_convert(&radix, sink, a, an, 0, scratch, sn);
+            BIGINT_TIME_END(timer);
+        }
+
+        if (scratch != NULL) {
+            scratch_pop(&frame);
+        }
+
+        bigint_radix_free(&radix);
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    if (sink->ok && sink->used > 0 && sink->flush != NULL) {
+        sink->ok = sink->flush(sink);
+    }
+
+    return sink->ok;
+}
+
+bool bigint_write(FILE* stream, bigint_t* number, unsigned base)
+{
+    bigint_sink_t sink = {
+        .buffer   = malloc(BIGINT_IO_BUFFER),
+        .capacity = BIGINT_IO_BUFFER,
+        .ok       = true,
+        .flush    = bigint_sink_flush_stream,
+        .stream   = stream,
+    };
+
+    if (sink.buffer == NULL) {
+        return false;
+    }
+
+    bool ok = bigint_write_sink(&sink, number, base);
+    free(sink.buffer);
+    return ok;
+}
+
+bool bigint_write_fd(int fd, bigint_t* number, unsigned base)
+{
+    bigint_sink_t sink = {
+        .buffer   = malloc(BIGINT_IO_BUFFER),
+        .capacity = BIGINT_IO_BUFFER,
+        .ok       = true,
+        .flush    = bigint_sink_flush_fd,
+        .fd       = fd,
+    };
+
+    if (sink.buffer == NULL) {
+        return false;
+    }
+
+    bool ok = bigint_write_sink(&sink, number, base);
+    free(sink.buffer);
+    return ok;
+}
+
+char* bigint_to_string(bigint_t* number, unsigned base)
+{
+    if (base < 2) {
+        return NULL;
+    }
+
+    // Every digit carries at least floor(log2(base)) bits.
+    size_t bits_per_digit = 0;
+    while ((2u << bits_per_digit) <= base) {
+        bits_per_digit++;
+    }
+
+    // No flush, so running out of room would fail the conversion.
+    bigint_sink_t sink = {
+        .capacity = bigint_bitlen(number) / bits_per_digit + 2,
+        .ok       = true,
+    };
+
+    sink.buffer = malloc(sink.capacity + 1);
+    if (sink.buffer == NULL) {
+        return NULL;
+    }
+
+    if (!bigint_write_sink(&sink, number, base)) {
+        free(sink.buffer);
+        return NULL;
+    }
+
+    sink.buffer[sink.used] = '\0';
+    return sink.buffer;
+}
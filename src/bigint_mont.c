@@ -0,0 +1,316 @@
+#include "bigint_mont.h"
+#include "limb.h"
+#include "scratch.h"
+#include "stats.h"
+
+#include<stdlib.h>
+#include<string.h>
+
+// Exponent bits consumed per multiplication in bigint_mont_powm, by exponent
+// size. The table of powers costs 2^k multiplications up front.
+static unsigned bigint_mont_window_bits(size_t bits)
+{
+    return bits > 512 ? 5 : bits > 128 ? 4 : bits > 16 ? 3 : 1;
+}
+
+// Operand slots after the product, then what limb_mul needs.
+#define BIGINT_MONT_X(mont)           ((mont)->scratch + 2 * (mont)->size + 1)
+#define BIGINT_MONT_Y(mont)           ((mont)->scratch + 3 * (mont)->size + 1)
+#define BIGINT_MONT_MUL_SCRATCH(mont) ((mont)->scratch + 4 * (mont)->size + 1)
+
+// r[n] = a[n] * b[n] / R mod m, for a and b below m. r may be a or b.
+static void bigint_mont_redc(bigint_mont_t* mont, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    size_t          n = mont->size;
+    uint32_t*       t = mont->scratch;
+    const uint32_t* m = mont->modulus;
+
+    t[0] = 0;
+    limb_mul(t + 1, a, n, b, n, BIGINT_MONT_MUL_SCRATCH(mont));
+
+    // Each round adds the multiple of m that clears the lowest limb left.
+    for (size_t i = 0; i < n; i++) {
+        size_t   low   = 2 * n - i;
+        uint32_t carry = limb_addmul_1(t + low - n + 1, m, n, t[low] * mont->inverse);
+
+        for (size_t j = low - n; carry != 0; j--) {
+            t[j] += carry;
+            carry = t[j] < carry;
+        }
+    }
+
+    // The top n + 1 limbs are now below 2m.
+    if (t[0] != 0 || limb_cmp(t + 1, m, n) >= 0) {
+        limb_sub(t + 1, t + 1, n, m, n);
+    }
+
+    memcpy(r, t + 1, n * sizeof(uint32_t));
+}
+
+// dst[n] = a mod m.
+static bool bigint_mont_load(bigint_mont_t* mont, uint32_t* dst, bigint_t* a)
+{
+    size_t          n = mont->size;
+    size_t          an;
+    const uint32_t* al = bigint_limbs(a, &an);
+
+    if (an > n || (an == n && limb_cmp(al, mont->modulus, n) >= 0)) {
+        bigint_t  m;
+        bigint_t* r = bigint_new();
+
+        bigint_wrap(&m, mont->modulus, n);
+        bool ok = r != NULL && bigint_divmod(NULL, r, a, &m);
+
+        if (ok) {
+            bigint_mont_load(mont, dst, r);
+        }
+
+        bigint_release(&m);
+        if (r != NULL) {
+            bigint_delete(r);
+        }
+        return ok;
+    }
+
+    memset(dst, 0, (n - an) * sizeof(uint32_t));
+    if (an > 0) {
+        memcpy(dst + n - an, al, an * sizeof(uint32_t));
+    }
+    return true;
+}
+
+static bool bigint_mont_store(bigint_mont_t* mont, bigint_t* result, const uint32_t* src)
+{
+    bigint_t view;
+    bigint_wrap(&view, src, mont->size);
+
+    bool ok = bigint_copy(result, &view);
+    bigint_release(&view);
+    return ok;
+}
+
+bool bigint_mont_init(bigint_mont_t* mont, bigint_t* modulus)
+{
+    size_t          n;
+    const uint32_t* ml = bigint_limbs(modulus, &n);
+
+    memset(mont, 0, sizeof(*mont));
+
+    if (n == 0 || (ml[n - 1] & 1) == 0) {
+        return false;
+    }
+
+    // modulus, one, r2, scratch for the 2n limb product plus a carry limb, two
+    // operands for the bigint_t level calls and the multiplication's scratch.
+    uint32_t* buffer = malloc((7 * n + 1 + limb_mul_scratch(n)) * sizeof(uint32_t));
+    if (buffer == NULL) {
+        return false;
+    }
+
+    mont->size    = n;
+    mont->modulus = buffer;
+    mont->one     = buffer + n;
+    mont->r2      = buffer + 2 * n;
+    mont->scratch = buffer + 3 * n;
+    memcpy(mont->modulus, ml, n * sizeof(uint32_t));
+
+    // Newton's iteration for 1 / m mod 2^32, every step doubles the correct
+    // bits and m is its own inverse modulo 8.
+    uint32_t low = ml[n - 1];
+    uint32_t x   = low;
+    for (int i = 0; i < 4; i++) {
+        x *= 2 - low * x;
+    }
+    mont->inverse = 0u - x;
+
+    bigint_t* power = bigint_new();
+    bool      ok = power != NULL
+                && bigint_set_u32(power, 1)
+                && bigint_shl(power, power, 32 * n)
+                && bigint_mont_load(mont, mont->one, power)
+                && bigint_shl(power, power, 32 * n)
+                && bigint_mont_load(mont, mont->r2, power);
+
+    if (power != NULL) {
+        bigint_delete(power);
+    }
+    if (!ok) {
+        bigint_mont_free(mont);
+    }
+    return ok;
+}
+
+void bigint_mont_free(bigint_mont_t* mont)
+{
+    free(mont->modulus);
+    memset(mont, 0, sizeof(*mont));
+}
+
+bool bigint_mont_to(bigint_mont_t* mont, bigint_t* result, bigint_t* a)
+{
+    uint32_t* x = BIGINT_MONT_X(mont);
+
+    if (!bigint_mont_load(mont, x, a)) {
+        return false;
+    }
+
+    bigint_mont_redc(mont, x, x, mont->r2);
+    return bigint_mont_store(mont, result, x);
+}
+
+bool bigint_mont_from(bigint_mont_t* mont, bigint_t* result, bigint_t* a)
+{
+    uint32_t* x = BIGINT_MONT_X(mont);
+    uint32_t* y = BIGINT_MONT_Y(mont);
+
+    if (!bigint_mont_load(mont, x, a)) {
+        return false;
+    }
+
+    memset(y, 0, mont->size * sizeof(uint32_t));
+    y[mont->size - 1] = 1;
+
+    bigint_mont_redc(mont, x, x, y);
+    return bigint_mont_store(mont, result, x);
+}
+
+bool bigint_mont_mul(bigint_mont_t* mont, bigint_t* result, bigint_t* a, bigint_t* b)
+{
+    uint32_t* x = BIGINT_MONT_X(mont);
+    uint32_t* y = BIGINT_MONT_Y(mont);
+
+    if (!bigint_mont_load(mont, x, a) || (b != a && !bigint_mont_load(mont, y, b))) {
+        return false;
+    }
+
+    // Passing the same vector twice lets limb_mul square.
+    bigint_mont_redc(mont, x, x, b == a ? x : y);
+    return bigint_mont_store(mont, result, x);
+}
+
+// Bits [pos - k, pos) of the exponent.
+static uint32_t bigint_mont_window(bigint_t* exponent, size_t pos, unsigned k)
+{
+    uint32_t w = 0;
+
+    for (unsigned i = 1; i <= k; i++) {
+        w = (w << 1) | (bigint_getbit(exponent, pos - i) != 0);
+    }
+
+    return w;
+}
+
+bool bigint_mont_powm(bigint_mont_t* mont, bigint_t* result, bigint_t* base, bigint_t* exponent)
+{
+    BIGINT_COUNT(BIGINT_STAT_POWM_MONT, mont->size);
+
+    size_t    n    = mont->size;
+    size_t    bits = bigint_bitlen(exponent);
+    unsigned  k    = bigint_mont_window_bits(bits);
+    uint32_t* acc  = BIGINT_MONT_X(mont);
+    uint32_t* b    = BIGINT_MONT_Y(mont);
+
+    // Reduced first, the division takes scratch too.
+    if (!bigint_mont_load(mont, b, base)) {
+        return false;
+    }
+
+    // Fixed window, table[i] = base^i in Montgomery form.
+    scratch_frame_t frame;
+    uint32_t*       table = scratch_push(&frame, ((size_t) 1 << k) * n);
+    if (table == NULL) {
+        return false;
+    }
+
+    memcpy(table, mont->one, n * sizeof(uint32_t));
+    bigint_mont_redc(mont, table + n, b, mont->r2);
+    for (size_t i = 2; i < ((size_t) 1 << k); i++) {
+        bigint_mont_redc(mont, table + i * n, table + (i - 1) * n, table + n);
+    }
+
+    bool started = false;
+    memcpy(acc, mont->one, n * sizeof(uint32_t));
+
+    for (size_t pos = (bits + k - 1) / k * k; pos > 0; pos -= k) {
+        uint32_t w = bigint_mont_window(exponent, pos, k);
+
+        if (!started) {
+            // Nothing to square yet.
+            memcpy(acc, table + w * n, n * sizeof(uint32_t));
+            started = w != 0;
+            continue;
+        }
+
+        for (unsigned i = 0; i < k; i++) {
+            bigint_mont_redc(mont, acc, acc, acc);
+        }
+        if (w != 0) {
+            bigint_mont_redc(mont, acc, acc, table + w * n);
+        }
+    }
+
+    scratch_pop(&frame);
+
+    memset(b, 0, n * sizeof(uint32_t));
+    b[n - 1] = 1;
+    bigint_mont_redc(mont, acc, acc, b);
+
+    return bigint_mont_store(mont, result, acc);
+}
+
+// Square and multiply with full divisions, for even moduli.
+static bool bigint_powm_plain(bigint_t* result, bigint_t* base, bigint_t* exponent, bigint_t* modulus)
+{
+    BIGINT_COUNT(BIGINT_STAT_POWM_PLAIN, modulus->size);
+
+    bigint_t* acc = bigint_new();
+    bigint_t* b   = bigint_new();
+    bool      ok  = acc != NULL && b != NULL
+                 && bigint_set_u32(acc, 1)
+                 && bigint_divmod(NULL, acc, acc, modulus)
+                 && bigint_divmod(NULL, b, base, modulus);
+
+    for (size_t i = bigint_bitlen(exponent); ok && i > 0; i--) {
+        ok = bigint_mul(acc, acc, acc) && bigint_divmod(NULL, acc, acc, modulus);
+
+        if (ok && bigint_getbit(exponent, i - 1)) {
+            ok = bigint_mul(acc, acc, b) && bigint_divmod(NULL, acc, acc, modulus);
+        }
+    }
+
+    if (ok) {
+        bigint_swap(result, acc);
+    }
+
+    if (acc != NULL) {
+        bigint_delete(acc);
+    }
+    if (b != NULL) {
+        bigint_delete(b);
+    }
+    return ok;
+}
+
+bool bigint_powm(bigint_t* result, bigint_t* base, bigint_t* exponent, bigint_t* modulus)
+{
+    if (bigint_is_zero(modulus)) {
+        return false;
+    }
+
+    BIGINT_TIME_BEGIN(BIGINT_STAT_POWM, timer, modulus->size);
+    bool ok;
+
+    if (bigint_getbit(modulus, 0) == 0) {
+        ok = bigint_powm_plain(result, base, exponent, modulus);
+
+    } else {
+        bigint_mont_t mont;
+
+        ok = bigint_mont_init(&mont, modulus)
+          && bigint_mont_powm(&mont, result, base, exponent);
+        bigint_mont_free(&mont);
+    }
+
+    BIGINT_TIME_END(timer);
+    return ok;
+}
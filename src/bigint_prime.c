@@ -0,0 +1,432 @@
+#include "bigint_prime.h"
+#include "bigint_mont.h"
+#include "bigint_root.h"
+
+#include<string.h>
+
+// Odd primes below 2048, used for trial division and sieving.
+#define BIGINT_SMALL_PRIMES      308
+#define BIGINT_SMALL_PRIME_LIMIT 2048
+
+// Everything below this is settled by trial division alone.
+#define BIGINT_TRIAL_BITS 22
+
+// Odd candidates sieved per pass of bigint_next_prime.
+#define BIGINT_SIEVE_WINDOW 4096
+
+static const uint16_t bigint_small_primes[BIGINT_SMALL_PRIMES] = {
+       3,    5,    7,   11,   13,   17,   19,   23,   29,   31,   37,   41,   43,   47,
+      53,   59,   61,   67,   71,   73,   79,   83,   89,   97,  101,  103,  107,  109,
+     113,  127,  131,  137,  139,  149,  151,  157,  163,  167,  173,  179,  181,  191,
+     193,  197,  199,  211,  223,  227,  229,  233,  239,  241,  251,  257,  263,  269,
+     271,  277,  281,  283,  293,  307,  311,  313,  317,  331,  337,  347,  349,  353,
+     359,  367,  373,  379,  383,  389,  397,  401,  409,  419,  421,  431,  433,  439,
+     443,  449,  457,  461,  463,  467,  479,  487,  491,  499,  503,  509,  521,  523,
+     541,  547,  557,  563,  569,  571,  577,  587,  593,  599,  601,  607,  613,  617,
+     619,  631,  641,  643,  647,  653,  659,  661,  673,  677,  683,  691,  701,  709,
+     719,  727,  733,  739,  743,  751,  757,  761,  769,  773,  787,  797,  809,  811,
+     821,  823,  827,  829,  839,  853,  857,  859,  863,  877,  881,  883,  887,  907,
+     911,  919,  929,  937,  941,  947,  953,  967,  971,  977,  983,  991,  997, 1009,
+    1013, 1019, 1021, 1031, 1033, 1039, 1049, 1051, 1061, 1063, 1069, 1087, 1091, 1093,
+    1097, 1103, 1109, 1117, 1123, 1129, 1151, 1153, 1163, 1171, 1181, 1187, 1193, 1201,
+    1213, 1217, 1223, 1229, 1231, 1237, 1249, 1259, 1277, 1279, 1283, 1289, 1291, 1297,
+    1301, 1303, 1307, 1319, 1321, 1327, 1361, 1367, 1373, 1381, 1399, 1409, 1423, 1427,
+    1429, 1433, 1439, 1447, 1451, 1453, 1459, 1471, 1481, 1483, 1487, 1489, 1493, 1499,
+    1511, 1523, 1531, 1543, 1549, 1553, 1559, 1567, 1571, 1579, 1583, 1597, 1601, 1607,
+    1609, 1613, 1619, 1621, 1627, 1637, 1657, 1663, 1667, 1669, 1693, 1697, 1699, 1709,
+    1721, 1723, 1733, 1741, 1747, 1753, 1759, 1777, 1783, 1787, 1789, 1801, 1811, 1823,
+    1831, 1847, 1861, 1867, 1871, 1873, 1877, 1879, 1889, 1901, 1907, 1913, 1931, 1933,
+    1949, 1951, 1973, 1979, 1987, 1993, 1997, 1999, 2003, 2011, 2017, 2027, 2029, 2039
+};
+
+// residues[i] = n mod bigint_small_primes[i]. Several primes are taken at once,
+// so it only costs one pass over the limbs per 32 bit product of primes.
+static void bigint_prime_residues(bigint_t* n, uint32_t* residues)
+{
+    size_t i = 0;
+
+    while (i < BIGINT_SMALL_PRIMES) {
+        uint64_t product = bigint_small_primes[i];
+        size_t   end     = i + 1;
+
+        while (end < BIGINT_SMALL_PRIMES && product * bigint_small_primes[end] <= UINT32_MAX) {
+            product *= bigint_small_primes[end++];
+        }
+
+        uint32_t r;
+        bigint_divmod_u32(NULL, &r, n, (uint32_t) product);
+
+        for (; i < end; i++) {
+            residues[i] = r % bigint_small_primes[i];
+        }
+    }
+}
+
+static bool bigint_prime_small(uint64_t n)
+{
+    if (n < 3) {
+        return n == 2;
+    }
+    if (n % 2 == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < BIGINT_SMALL_PRIMES; i++) {
+        uint64_t p = bigint_small_primes[i];
+        if (p * p > n) {
+            break;
+        }
+        if (n % p == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool bigint_prime_new(bigint_t** all, size_t count)
+{
+    bool ok = true;
+
+    for (size_t i = 0; i < count; i++) {
+        all[i] = bigint_new();
+        ok     = ok && all[i] != NULL;
+    }
+
+    return ok;
+}
+
+static void bigint_prime_delete(bigint_t** all, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (all[i] != NULL) {
+            bigint_delete(all[i]);
+        }
+    }
+}
+
+// Number of trailing zero bits, for a non zero x.
+static size_t bigint_prime_twos(bigint_t* x)
+{
+    size_t twos = 0;
+    while (bigint_getbit(x, twos) == 0) {
+        twos++;
+    }
+    return twos;
+}
+
+// Strong probable prime test to the given base, for odd n > base.
+static bool bigint_prime_mr(bigint_mont_t* mont, bigint_t* n, uint32_t base, bool* probable)
+{
+    bigint_t* v[4];
+    bool      ok = bigint_prime_new(v, 4);
+
+    bigint_t* nm1 = v[0];
+    bigint_t* d   = v[1];
+    bigint_t* x   = v[2];
+    bigint_t* y   = v[3];
+    size_t    s   = 0;
+
+    // n - 1 = d 2^s, then x = base^d has to be 1 or reach -1 by squaring.
+    ok = ok && bigint_sub_u32(nm1, n, 1);
+    if (ok) {
+        s  = bigint_prime_twos(nm1);
+        ok = bigint_shr(d, nm1, s)
+          && bigint_set_u32(x, base)
+          && bigint_mont_powm(mont, x, x, d);
+    }
+
+    *probable = ok && (bigint_bitlen(x) == 1 || bigint_cmp(x, nm1) == 0);
+
+    if (ok && !*probable && s > 1) {
+        // Squarings stay in Montgomery form, -1 included.
+        ok = bigint_mont_to(mont, x, x) && bigint_mont_to(mont, y, nm1);
+
+        for (size_t i = 1; ok && i < s && !*probable; i++) {
+            ok        = bigint_mont_mul(mont, x, x, x);
+            *probable = ok && bigint_cmp(x, y) == 0;
+        }
+    }
+
+    bigint_prime_delete(v, 4);
+    return ok;
+}
+
+// Jacobi symbol (a / n), for odd n.
+static int bigint_jacobi_u64(uint64_t a, uint64_t n)
+{
+    int j = 1;
+
+    a %= n;
+    while (a != 0) {
+        while ((a & 1) == 0) {
+            a >>= 1;
+            if ((n & 7) == 3 || (n & 7) == 5) {
+                j = -j;
+            }
+        }
+
+        uint64_t t = a;
+        a = n;
+        n = t;
+        if ((a & 3) == 3 && (n & 3) == 3) {
+            j = -j;
+        }
+        a %= n;
+    }
+
+    return n == 1 ? j : 0;
+}
+
+// Jacobi symbol (D / n) for a small odd D and odd n, by reciprocity.
+static int bigint_jacobi(int64_t D, bigint_t* n)
+{
+    uint32_t a    = (uint32_t) (D < 0 ? -D : D);
+    uint32_t low  = (uint32_t) bigint_get_u64(n);
+    uint32_t r;
+
+    bigint_divmod_u32(NULL, &r, n, a);
+
+    int j = bigint_jacobi_u64(r, a);
+    if ((a & 3) == 3 && (low & 3) == 3) {
+        j = -j;
+    }
+    if (D < 0 && (low & 3) == 3) {
+        j = -j;
+    }
+
+    return j;
+}
+
+// r = v mod n, for |v| < n.
+static bool bigint_prime_set_signed(bigint_t* r, bigint_t* n, int64_t v)
+{
+    return bigint_set_u64(r, (uint64_t) (v < 0 ? -v : v))
+        && (v >= 0 || bigint_sub(r, n, r));
+}
+
+static bool bigint_addmod(bigint_t* r, bigint_t* a, bigint_t* b, bigint_t* n)
+{
+    return bigint_add(r, a, b)
+        && (bigint_cmp(r, n) < 0 || bigint_sub(r, r, n));
+}
+
+static bool bigint_submod(bigint_t* r, bigint_t* a, bigint_t* b, bigint_t* n)
+{
+    if (bigint_cmp(a, b) >= 0) {
+        return bigint_sub(r, a, b);
+    }
+    return bigint_sub(r, b, a) && bigint_sub(r, n, r);
+}
+
+// r = a / 2 mod n, for odd n.
+static bool bigint_halfmod(bigint_t* r, bigint_t* a, bigint_t* n)
+{
+    if (bigint_getbit(a, 0)) {
+        return bigint_add(r, a, n) && bigint_shr(r, r, 1);
+    }
+    return bigint_shr(r, a, 1);
+}
+
+// Strong Lucas probable prime test with Selfridge's parameters: the first D
+// in 5, -7, 9, -11, ... with (D / n) = -1, P = 1 and Q = (1 - D) / 4. For odd
+// n above 2048^2 without small factors.
+static bool bigint_prime_lucas(bigint_mont_t* mont, bigint_t* n, bool* probable)
+{
+    int64_t D = 5;
+    int     j;
+
+    *probable = false;
+
+    for (int i = 0; (j = bigint_jacobi(D, n)) == 1; i++) {
+        // Squares never give -1, so don't look forever.
+        if (i == 8 && bigint_is_square(n)) {
+            return true;
+        }
+        D = D > 0 ? -(D + 2) : -D + 2;
+    }
+
+    // D shares a factor with n, which is bigger than it.
+    if (j == 0) {
+        return true;
+    }
+
+    bigint_t* v[8];
+    bool      ok = bigint_prime_new(v, 8);
+
+    bigint_t* d  = v[0];
+    bigint_t* U  = v[1];
+    bigint_t* V  = v[2];
+    bigint_t* Qk = v[3];
+    bigint_t* Dm = v[4];
+    bigint_t* Qm = v[5];
+    bigint_t* t  = v[6];
+    bigint_t* w  = v[7];
+    size_t    s  = 0;
+
+    // n + 1 = d 2^s. Everything below is in Montgomery form, which doesn't
+    // change additions, halving or comparing against zero.
+    ok = ok && bigint_add_u32(d, n, 1);
+    if (ok) {
+        s  = bigint_prime_twos(d);
+        ok = bigint_shr(d, d, s)
+          && bigint_prime_set_signed(Dm, n, D)
+          && bigint_mont_to(mont, Dm, Dm)
+          && bigint_prime_set_signed(Qm, n, (1 - D) / 4)
+          && bigint_mont_to(mont, Qm, Qm)
+          && bigint_set_u32(U, 1)
+          && bigint_mont_to(mont, U, U)
+          && bigint_copy(V, U)
+          && bigint_copy(Qk, Qm);
+    }
+
+    // U_k, V_k and Q^k for k = 1, then left to right over the bits of d with
+    //   U_2k = U_k V_k,  V_2k = V_k^2 - 2 Q^k
+    //   U_k+1 = (U_k + V_k) / 2,  V_k+1 = (D U_k + V_k) / 2
+    for (size_t i = bigint_bitlen(d) - 1; ok && i > 0; i--) {
+        ok = bigint_mont_mul(mont, U, U, V)
+          && bigint_mont_mul(mont, V, V, V)
+          && bigint_addmod(t, Qk, Qk, n)
+          && bigint_submod(V, V, t, n)
+          && bigint_mont_mul(mont, Qk, Qk, Qk);
+
+        if (ok && bigint_getbit(d, i - 1)) {
+            ok = bigint_addmod(t, U, V, n)
+              && bigint_mont_mul(mont, w, Dm, U)
+              && bigint_addmod(w, w, V, n)
+              && bigint_halfmod(U, t, n)
+              && bigint_halfmod(V, w, n)
+              && bigint_mont_mul(mont, Qk, Qk, Qm);
+        }
+    }
+
+    *probable = ok && (bigint_is_zero(U) || bigint_is_zero(V));
+
+    // Or V_d2^r = 0 for some 0 < r < s.
+    for (size_t r = 1; ok && r < s && !*probable; r++) {
+        ok = bigint_mont_mul(mont, V, V, V)
+          && bigint_addmod(t, Qk, Qk, n)
+          && bigint_submod(V, V, t, n)
+          && bigint_mont_mul(mont, Qk, Qk, Qk);
+
+        *probable = ok && bigint_is_zero(V);
+    }
+
+    bigint_prime_delete(v, 8);
+    return ok;
+}
+
+// Baillie-PSW plus `reps` more bases, for odd n above 2048^2 that passed
+// trial division.
+static bool bigint_prime_test(bigint_t* n, uint32_t reps, bool* probable)
+{
+    bigint_mont_t mont;
+
+    if (!bigint_mont_init(&mont, n)) {
+        return false;
+    }
+
+    bool ok = bigint_prime_mr(&mont, n, 2, probable)
+           && (!*probable || bigint_prime_lucas(&mont, n, probable));
+
+    for (uint32_t i = 0; ok && *probable && i < reps && i < BIGINT_SMALL_PRIMES; i++) {
+        ok = bigint_prime_mr(&mont, n, bigint_small_primes[i], probable);
+    }
+
+    bigint_mont_free(&mont);
+    return ok;
+}
+
+bool bigint_is_probab_prime(bigint_t* n, uint32_t reps)
+{
+    if (bigint_bitlen(n) <= BIGINT_TRIAL_BITS) {
+        return bigint_prime_small(bigint_get_u64(n));
+    }
+
+    if (bigint_getbit(n, 0) == 0) {
+        return false;
+    }
+
+    uint32_t residues[BIGINT_SMALL_PRIMES];
+    bigint_prime_residues(n, residues);
+
+    for (size_t i = 0; i < BIGINT_SMALL_PRIMES; i++) {
+        if (residues[i] == 0) {
+            return false;
+        }
+    }
+
+    bool probable;
+    return bigint_prime_test(n, reps, &probable) && probable;
+}
+
+bool bigint_next_prime(bigint_t* result, bigint_t* n)
+{
+    bigint_t* v[2];
+    bool      ok = bigint_prime_new(v, 2);
+
+    bigint_t* c = v[0];
+    bigint_t* t = v[1];
+
+    if (ok && bigint_bitlen(n) <= BIGINT_TRIAL_BITS) {
+        for (uint64_t x = bigint_get_u64(n) + 1; x < (1u << BIGINT_TRIAL_BITS); x++) {
+            if (bigint_prime_small(x)) {
+                ok = bigint_set_u64(result, x);
+                bigint_prime_delete(v, 2);
+                return ok;
+            }
+        }
+        ok = bigint_set_u32(c, 1u << BIGINT_TRIAL_BITS);
+    } else {
+        ok = ok && bigint_add_u32(c, n, 1);
+    }
+
+    if (ok && bigint_getbit(c, 0) == 0) {
+        ok = bigint_add_u32(c, c, 1);
+    }
+
+    // Candidate j of the window is c + 2j. All of them are above the sieving
+    // primes, so any hit means composite.
+    uint32_t residues[BIGINT_SMALL_PRIMES];
+    uint8_t  sieve[BIGINT_SIEVE_WINDOW];
+    bool     found = false;
+
+    if (ok) {
+        bigint_prime_residues(c, residues);
+    }
+
+    while (ok && !found) {
+        memset(sieve, 0, sizeof(sieve));
+
+        for (size_t i = 0; i < BIGINT_SMALL_PRIMES; i++) {
+            uint32_t p = bigint_small_primes[i];
+
+            // c + 2j = 0 mod p for j = -c / 2 mod p.
+            for (uint32_t j = (p - residues[i]) % p * ((p + 1) / 2) % p; j < BIGINT_SIEVE_WINDOW; j += p) {
+                sieve[j] = 1;
+            }
+        }
+
+        for (uint32_t j = 0; ok && !found && j < BIGINT_SIEVE_WINDOW; j++) {
+            if (!sieve[j]) {
+                ok = bigint_add_u32(t, c, 2 * j)
+                  && bigint_prime_test(t, 0, &found);
+            }
+        }
+
+        if (ok && !found) {
+            ok = bigint_add_u32(c, c, 2 * BIGINT_SIEVE_WINDOW);
+
+            for (size_t i = 0; i < BIGINT_SMALL_PRIMES; i++) {
+                residues[i] = (residues[i] + 2 * BIGINT_SIEVE_WINDOW) % bigint_small_primes[i];
+            }
+        }
+    }
+
+    if (ok) {
+        bigint_swap(result, t);
+    }
+
+    bigint_prime_delete(v, 2);
+    return ok;
+}
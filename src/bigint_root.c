@@ -0,0 +1,354 @@
+#include "bigint_root.h"
+#include "stats.h"
+
+#include<math.h>
+
+// Numbers up to this many bits are handled with native arithmetic.
+#define BIGINT_ROOT_NATIVE_BITS 64
+
+// Squares modulo 256, 63, 65 and 11 as bitmaps. Together they reject all but
+// about 1 in 150 non-squares with a single pass over the limbs.
+static const uint64_t bigint_sq256[4] = {
+    0x0202021202030213ULL, 0x0202021202020213ULL, 0x0202021202030212ULL, 0x0202021202020212ULL
+};
+static const uint64_t bigint_sq63[1] = { 0x0402483012450293ULL };
+static const uint64_t bigint_sq65[2] = { 0x218A019866014613ULL, 0x0000000000000001ULL };
+static const uint64_t bigint_sq11[1] = { 0x000000000000023BULL };
+
+#define BIGINT_IS_RESIDUE(table, r) (((table)[(r) / 64] >> ((r) % 64)) & 1)
+
+// a^n, or UINT64_MAX if it doesn't fit.
+static uint64_t bigint_root_pow_u64(uint64_t a, uint32_t n)
+{
+    unsigned __int128 result = 1;
+
+    for (uint32_t i = 0; i < n; i++) {
+        result *= a;
+        if (result > UINT64_MAX) {
+            return UINT64_MAX;
+        }
+    }
+
+    return (uint64_t) result;
+}
+
+// floor(a^(1/n)) by Newton's iteration from above.
+static uint64_t bigint_root_u64(uint64_t a, uint32_t n)
+{
+    if (a < 2 || n == 1) {
+        return a;
+    }
+
+    size_t   bits = 64 - (size_t) __builtin_clzll(a);
+    uint64_t x    = 1ull << ((bits + n - 1) / n < 63 ? (bits + n - 1) / n : 63);
+
+    while (true) {
+        uint64_t p = bigint_root_pow_u64(x, n - 1);
+        uint64_t y = (uint64_t) (((n - 1) * (unsigned __int128) x + a / p) / n);
+        if (y >= x) {
+            break;
+        }
+        x = y;
+    }
+
+    // The overflow guard above may leave it one short.
+    while (bigint_root_pow_u64(x + 1, n) <= a && bigint_root_pow_u64(x + 1, n) != UINT64_MAX) {
+        x++;
+    }
+
+    return x;
+}
+
+// Newton's iteration x' = ((n - 1) x + a / x^(n - 1)) / n, which decreases
+// monotonically to the root as long as x starts at or above it.
+static bool bigint_root_newton(bigint_t* x, bigint_t* a, uint32_t n)
+{
+    bigint_t* y = bigint_new();
+    bigint_t* t = bigint_new();
+    bool      ok = y != NULL && t != NULL;
+
+    while (ok) {
+        ok = (n == 2 ? bigint_copy(t, x) : bigint_pow_u32(t, x, n - 1))
+          && bigint_divmod(t, NULL, a, t)
+          && bigint_mul_u32(y, x, n - 1)
+          && bigint_add(y, y, t)
+          && bigint_divmod_u32(y, NULL, y, n);
+
+        if (!ok || bigint_cmp(y, x) >= 0) {
+            break;
+        }
+        bigint_swap(x, y);
+    }
+
+    if (y != NULL) {
+        bigint_delete(y);
+    }
+    if (t != NULL) {
+        bigint_delete(t);
+    }
+    return ok;
+}
+
+bool bigint_root(bigint_t* root, bigint_t* a, uint32_t n)
+{
+    size_t bits = bigint_bitlen(a);
+
+    if (n == 0) {
+        return false;
+    }
+
+    if (n == 1) {
+        return bigint_copy(root, a);
+    }
+
+    // a < 2^bits <= 2^n, nothing above 1 fits.
+    if (n >= bits) {
+        return bigint_set_u32(root, bits > 0);
+    }
+
+    if (bits <= BIGINT_ROOT_NATIVE_BITS) {
+        return bigint_set_u64(root, bigint_root_u64(bigint_get_u64(a), n));
+    }
+
+    bigint_t* x = bigint_new();
+    if (x == NULL) {
+        return false;
+    }
+
+    // Precision doubling: the root of the top half of the bits, scaled back
+    // up, is already within a few ulps of the answer, so Newton only has to
+    // run for a step or two at full size.
+    size_t k  = bits / (2 * (size_t) n);
+    bool   ok;
+
+    if (k > 0) {
+        ok = bigint_shr(x, a, k * n)
+          && bigint_root(x, x, n)
+          && bigint_add_u32(x, x, 1)
+          && bigint_shl(x, x, k);
+    } else {
+        // The root is tiny, 2^ceil(bits / n) is a good enough start.
+        ok = bigint_set_u32(x, 1) && bigint_shl(x, x, (bits + n - 1) / n);
+    }
+
+    if (ok) {
+        BIGINT_TIME_BEGIN(BIGINT_STAT_ROOT, timer, (bits + 31) / 32);
+        ok = bigint_root_newton(x, a, n);
+        BIGINT_TIME_END(timer);
+    }
+
+    if (ok) {
+        bigint_swap(root, x);
+    }
+
+    bigint_delete(x);
+    return ok;
+}
+
+bool bigint_sqrt(bigint_t* root, bigint_t* a)
+{
+    return bigint_root(root, a, 2);
+}
+
+bool bigint_sqrtrem(bigint_t* root, bigint_t* remainder, bigint_t* a)
+{
+    bigint_t* s = bigint_new();
+    if (s == NULL) {
+        return false;
+    }
+
+    bool ok = bigint_root(s, a, 2);
+
+    if (ok && remainder != NULL) {
+        bigint_t* square = bigint_new();
+        ok = square != NULL
+          && bigint_mul(square, s, s)
+          && bigint_sub(remainder, a, square);
+        if (square != NULL) {
+            bigint_delete(square);
+        }
+    }
+
+    if (ok && root != NULL) {
+        bigint_swap(root, s);
+    }
+
+    bigint_delete(s);
+    return ok;
+}
+
+bool bigint_is_square(bigint_t* a)
+{
+    size_t          an;
+    const uint32_t* al = bigint_limbs(a, &an);
+
+    if (an == 0) {
+        return true;
+    }
+
+    if (!BIGINT_IS_RESIDUE(bigint_sq256, al[an - 1] & 0xFF)) {
+        return false;
+    }
+
+    // 63 * 65 * 11, all three from one division.
+    uint32_t r;
+    if (!bigint_divmod_u32(NULL, &r, a, 45045)
+        || !BIGINT_IS_RESIDUE(bigint_sq63, r % 63)
+        || !BIGINT_IS_RESIDUE(bigint_sq65, r % 65)
+        || !BIGINT_IS_RESIDUE(bigint_sq11, r % 11)) {
+        return false;
+    }
+
+    bigint_t* rem = bigint_new();
+    bool      is  = rem != NULL
+                 && bigint_sqrtrem(NULL, rem, a)
+                 && bigint_is_zero(rem);
+
+    if (rem != NULL) {
+        bigint_delete(rem);
+    }
+    return is;
+}
+
+static bool bigint_is_prime_u32(uint32_t n)
+{
+    if (n < 2) {
+        return false;
+    }
+    for (uint32_t d = 2; (uint64_t) d * d <= n; d++) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t bigint_powmod_u32(uint32_t base, uint32_t exponent, uint32_t mod)
+{
+    uint64_t result = 1;
+    uint64_t b      = base % mod;
+
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            result = result * b % mod;
+        }
+        b = b * b % mod;
+    }
+
+    return (uint32_t) result;
+}
+
+// Cheap necessary condition for a being a p-th power: for primes q = 1 mod p,
+// a mod q must be a p-th power residue, which only 1 in p of them are.
+static bool bigint_may_be_power(bigint_t* a, uint32_t p)
+{
+    int checked = 0;
+
+    for (uint64_t q = 2 * (uint64_t) p + 1; checked < 4 && q <= UINT32_MAX; q += 2 * (uint64_t) p) {
+        if (!bigint_is_prime_u32((uint32_t) q)) {
+            continue;
+        }
+
+        uint32_t r;
+        if (!bigint_divmod_u32(NULL, &r, a, (uint32_t) q)) {
+            return false;
+        }
+
+        if (r != 0 && bigint_powmod_u32(r, (uint32_t) ((q - 1) / p), (uint32_t) q) != 1) {
+            return false;
+        }
+        checked++;
+    }
+
+    return true;
+}
+
+// Largest primes below 2^32, for comparing candidate roots without building
+// the full power.
+static const uint32_t bigint_root_check_primes[2] = { 4294967291u, 4294967279u };
+
+bool bigint_is_perfect_power(bigint_t* a)
+{
+    size_t bits = bigint_bitlen(a);
+
+    if (bits <= 1) {
+        return true;
+    }
+
+    // a = 2^t * odd, any exponent has to divide t.
+    size_t twos = 0;
+    while (bigint_getbit(a, twos) == 0) {
+        twos++;
+    }
+
+    if (bigint_is_square(a)) {
+        return true;
+    }
+
+    uint32_t residues[2];
+    for (size_t i = 0; i < 2; i++) {
+        if (!bigint_divmod_u32(NULL, &residues[i], a, bigint_root_check_primes[i])) {
+            return false;
+        }
+    }
+
+    // log2(a) from its top 64 bits, to estimate small roots directly.
+    bigint_t* shifted = bigint_new();
+    if (shifted == NULL || !bigint_shr(shifted, a, bits > 64 ? bits - 64 : 0)) {
+        if (shifted != NULL) {
+            bigint_delete(shifted);
+        }
+        return false;
+    }
+    double log2a = log2((double) bigint_get_u64(shifted)) + (double) (bits > 64 ? bits - 64 : 0);
+    bigint_delete(shifted);
+
+    bigint_t* root  = bigint_new();
+    bigint_t* check = bigint_new();
+    bool      found = false;
+
+    for (uint32_t p = 3; root != NULL && check != NULL && p <= bits && !found; p += 2) {
+        if (!bigint_is_prime_u32(p) || (twos > 0 && twos % p != 0)) {
+            continue;
+        }
+
+        if (bits / p < 30) {
+            // The root is below 2^30, where the floating point estimate is
+            // exact once rounded. Compare residues before the real power.
+            uint32_t candidate = (uint32_t) (exp2(log2a / p) + 0.5);
+            bool     match     = candidate > 1;
+
+            for (size_t i = 0; i < 2 && match; i++) {
+                match = bigint_powmod_u32(candidate, p, bigint_root_check_primes[i]) == residues[i];
+            }
+
+            if (!match) {
+                continue;
+            }
+
+            if (!bigint_set_u32(root, candidate)) {
+                break;
+            }
+
+        } else if (!bigint_may_be_power(a, p)) {
+            continue;
+
+        } else if (!bigint_root(root, a, p)) {
+            break;
+        }
+
+        if (!bigint_pow_u32(check, root, p)) {
+            break;
+        }
+
+        found = bigint_cmp(check, a) == 0;
+    }
+
+    if (root != NULL) {
+        bigint_delete(root);
+    }
+    if (check != NULL) {
+        bigint_delete(check);
+    }
+    return found;
+}
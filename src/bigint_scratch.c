@@ -0,0 +1,153 @@
+#include "bigint_scratch.h"
+#include "bigint.h"
+#include "scratch.h"
+#include "stats.h"
+
+#include<pthread.h>
+#include<stdatomic.h>
+#include<stdlib.h>
+
+typedef struct scratch_stack_s
+{
+    uint32_t* limbs;
+    size_t    capacity;
+    size_t    top;
+    size_t    used; // Limbs in use, the side allocations too
+    size_t    peak; // Most ever used, what the stack grows to
+} scratch_stack_t;
+
+static _Thread_local scratch_stack_t scratch_local;
+
+static atomic_size_t  scratch_high_water;
+
+// The key's value is the thread's buffer, freed when the thread exits.
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  scratch_key;
+
+// Thread exit, counted like bigint_scratch_release.
+static void scratch_free(void* limbs)
+{
+    BIGINT_COUNT(BIGINT_STAT_FREE, scratch_local.capacity * sizeof(uint32_t));
+    free(limbs);
+}
+
+static void scratch_make_key(void)
+{
+    pthread_key_create(&scratch_key, scratch_free);
+}
+
+// Only on an empty stack, nothing points into it.
+static bool scratch_grow(scratch_stack_t* stack, size_t n)
+{
+    uint32_t* limbs = malloc(n * sizeof(uint32_t));
+
+    if (limbs == NULL) {
+        return false;
+    }
+
+    if (stack->limbs != NULL) {
+        BIGINT_COUNT(BIGINT_STAT_FREE, stack->capacity * sizeof(uint32_t));
+    }
+    BIGINT_COUNT(BIGINT_STAT_ALLOC, n * sizeof(uint32_t));
+
+    free(stack->limbs);
+    stack->limbs    = limbs;
+    stack->capacity = n;
+
+    pthread_once(&scratch_once, scratch_make_key);
+    pthread_setspecific(scratch_key, limbs);
+    return true;
+}
+
+uint32_t* scratch_push(scratch_frame_t* frame, size_t n)
+{
+    scratch_stack_t* stack = &scratch_local;
+
+    n = MAX(n, 1);
+
+    frame->mark = stack->top;
+    frame->size = n;
+    frame->heap = NULL;
+
+    stack->used += n;
+    stack->peak  = MAX(stack->peak, stack->used);
+
+    size_t bytes = stack->used * sizeof(uint32_t);
+    size_t seen  = atomic_load_explicit(&scratch_high_water, memory_order_relaxed);
+    while (bytes > seen && !atomic_compare_exchange_weak_explicit(&scratch_high_water, &seen, bytes, memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    // Grown to the most this thread has needed so far, so a call that
+    // overflowed once fits the next time.
+    if (stack->top == 0 && stack->capacity < n && !scratch_grow(stack, stack->peak)) {
+        scratch_grow(stack, n);
+    }
+
+    if (stack->capacity - stack->top >= n) {
+        stack->top += n;
+        return stack->limbs + frame->mark;
+    }
+
+    frame->heap = malloc(n * sizeof(uint32_t));
+    if (frame->heap == NULL) {
+        stack->used -= n;
+        frame->size  = 0;
+    } else {
+        BIGINT_COUNT(BIGINT_STAT_ALLOC, n * sizeof(uint32_t));
+    }
+    return frame->heap;
+}
+
+void scratch_pop(scratch_frame_t* frame)
+{
+    scratch_stack_t* stack = &scratch_local;
+
+    stack->used -= frame->size;
+
+    if (frame->heap != NULL) {
+        BIGINT_COUNT(BIGINT_STAT_FREE, frame->size * sizeof(uint32_t));
+        free(frame->heap);
+    } else {
+        stack->top = frame->mark;
+    }
+}
+
+size_t bigint_scratch_high_water(void)
+{
+    return atomic_load_explicit(&scratch_high_water, memory_order_relaxed);
+}
+
+void bigint_scratch_reset_high_water(void)
+{
+    atomic_store_explicit(&scratch_high_water, 0, memory_order_relaxed);
+}
+
+size_t bigint_scratch_capacity(void)
+{
+    return scratch_local.capacity * sizeof(uint32_t);
+}
+
+bool bigint_scratch_reserve(size_t bytes)
+{
+    size_t n = (bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    return scratch_local.capacity >= n || scratch_grow(&scratch_local, n);
+}
+
+void bigint_scratch_release(void)
+{
+    scratch_stack_t* stack = &scratch_local;
+
+    if (stack->limbs != NULL) {
+        BIGINT_COUNT(BIGINT_STAT_FREE, stack->capacity * sizeof(uint32_t));
+    }
+
+    free(stack->limbs);
+    stack->limbs    = NULL;
+    stack->capacity = 0;
+    stack->peak     = 0;
+
+    if (pthread_once(&scratch_once, scratch_make_key) == 0) {
+        pthread_setspecific(scratch_key, NULL);
+    }
+}
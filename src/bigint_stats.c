@@ -0,0 +1,256 @@
+#include "bigint_stats.h"
+#include "stats.h"
+
+#include<string.h>
+
+static const char* const bigint_stat_names[BIGINT_STATS] = {
+    "ADD",
+    "SUB",
+    "SHIFT",
+    "MUL",
+    "DIVMOD",
+    "POWM",
+    "GCD",
+    "ROOT",
+    "RADIX",
+    "MUL_BASECASE",
+    "MUL_KARATSUBA",
+    "SQR_BASECASE",
+    "SQR_KARATSUBA",
+    "DIV_1",
+    "DIV_KNUTH",
+    "POWM_MONT",
+    "POWM_PLAIN",
+    "GCD_BINARY",
+    "GCD_EUCLID",
+    "GCD_LEHMER",
+    "GCD_HALF",
+    "RADIX_BASECASE",
+    "RADIX_DC",
+    "ALLOC",
+    "FREE",
+    "RESIZE_REALLOC",
+    "RESIZE_INPLACE",
+    "UNSHARE_COPY",
+};
+
+const char* bigint_stat_name(bigint_stat_t stat)
+{
+    return bigint_stat_names[stat];
+}
+
+#ifdef BIGINT_STATS_ENABLED
+
+#include<pthread.h>
+#include<stdatomic.h>
+#include<stdlib.h>
+#include<time.h>
+
+// Only its own thread writes a block, so counting is a relaxed load and
+// store. The atomics are for the readers.
+typedef struct bigint_stats_block_s
+{
+    atomic_uint_fast64_t         calls[BIGINT_STATS];
+    atomic_uint_fast64_t         units[BIGINT_STATS];
+    atomic_uint_fast64_t         nanoseconds[BIGINT_STATS];
+    struct bigint_stats_block_s* prev;
+    struct bigint_stats_block_s* next;
+} bigint_stats_block_t;
+
+static _Thread_local bigint_stats_block_t* bigint_stats_local;
+
+// Every live block, plus the totals of the threads that exited.
+static pthread_mutex_t       bigint_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static bigint_stats_block_t* bigint_stats_blocks;
+static bigint_stat_value_t   bigint_stats_retired[BIGINT_STATS];
+
+static pthread_once_t        bigint_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t         bigint_stats_key;
+
+static _Atomic(bigint_stats_hook_t) bigint_stats_hook;
+static _Atomic(void*)               bigint_stats_hook_data;
+
+static void bigint_stats_add(atomic_uint_fast64_t* counter, uint64_t value)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+// Thread exit, folds the block into the retired totals.
+static void bigint_stats_retire(void* data)
+{
+    bigint_stats_block_t* block = data;
+
+    pthread_mutex_lock(&bigint_stats_lock);
+
+    for (int i = 0; i < BIGINT_STATS; i++) {
+        bigint_stats_retired[i].calls       += atomic_load_explicit(&block->calls[i], memory_order_relaxed);
+        bigint_stats_retired[i].units       += atomic_load_explicit(&block->units[i], memory_order_relaxed);
+        bigint_stats_retired[i].nanoseconds += atomic_load_explicit(&block->nanoseconds[i], memory_order_relaxed);
+    }
+
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        bigint_stats_blocks = block->next;
+    }
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+
+    pthread_mutex_unlock(&bigint_stats_lock);
+
+    bigint_stats_local = NULL;
+    free(block);
+}
+
+static void bigint_stats_make_key(void)
+{
+    pthread_key_create(&bigint_stats_key, bigint_stats_retire);
+}
+
+// This thread's block, registered on first use. NULL when out of memory, the
+// counts are dropped then.
+static bigint_stats_block_t* bigint_stats_block(void)
+{
+    bigint_stats_block_t* block = bigint_stats_local;
+
+    if (block != NULL) {
+        return block;
+    }
+
+    block = calloc(1, sizeof(bigint_stats_block_t));
+    if (block == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&bigint_stats_once, bigint_stats_make_key);
+    pthread_setspecific(bigint_stats_key, block);
+
+    pthread_mutex_lock(&bigint_stats_lock);
+    block->next = bigint_stats_blocks;
+    if (block->next != NULL) {
+        block->next->prev = block;
+    }
+    bigint_stats_blocks = block;
+    pthread_mutex_unlock(&bigint_stats_lock);
+
+    bigint_stats_local = block;
+    return block;
+}
+
+static uint64_t bigint_stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static void bigint_stats_trace(bigint_stat_t stat, bigint_trace_t event, uint64_t units)
+{
+    bigint_stats_hook_t hook = atomic_load_explicit(&bigint_stats_hook, memory_order_acquire);
+
+    if (hook != NULL) {
+        hook(stat, event, units, atomic_load_explicit(&bigint_stats_hook_data, memory_order_relaxed));
+    }
+}
+
+void bigint_stats_count(bigint_stat_t stat, uint64_t units)
+{
+    bigint_stats_block_t* block = bigint_stats_block();
+
+    if (block != NULL) {
+        bigint_stats_add(&block->calls[stat], 1);
+        bigint_stats_add(&block->units[stat], units);
+    }
+
+    bigint_stats_trace(stat, BIGINT_TRACE_COUNT, units);
+}
+
+bigint_stats_timer_t bigint_stats_begin(bigint_stat_t stat, uint64_t units)
+{
+    bigint_stats_trace(stat, BIGINT_TRACE_BEGIN, units);
+    return (bigint_stats_timer_t) { stat, units, bigint_stats_now() };
+}
+
+void bigint_stats_end(bigint_stats_timer_t* timer)
+{
+    uint64_t              elapsed = bigint_stats_now() - timer->start;
+    bigint_stats_block_t* block   = bigint_stats_block();
+
+    if (block != NULL) {
+        bigint_stats_add(&block->calls[timer->stat], 1);
+        bigint_stats_add(&block->units[timer->stat], timer->units);
+        bigint_stats_add(&block->nanoseconds[timer->stat], elapsed);
+    }
+
+    bigint_stats_trace(timer->stat, BIGINT_TRACE_END, timer->units);
+}
+
+bool bigint_stats_enabled(void)
+{
+    return true;
+}
+
+void bigint_stats_read(bigint_stat_value_t* values)
+{
+    pthread_mutex_lock(&bigint_stats_lock);
+
+    memcpy(values, bigint_stats_retired, sizeof(bigint_stats_retired));
+
+    for (bigint_stats_block_t* block = bigint_stats_blocks; block != NULL; block = block->next) {
+        for (int i = 0; i < BIGINT_STATS; i++) {
+            values[i].calls       += atomic_load_explicit(&block->calls[i], memory_order_relaxed);
+            values[i].units       += atomic_load_explicit(&block->units[i], memory_order_relaxed);
+            values[i].nanoseconds += atomic_load_explicit(&block->nanoseconds[i], memory_order_relaxed);
+        }
+    }
+
+    pthread_mutex_unlock(&bigint_stats_lock);
+}
+
+void bigint_stats_reset(void)
+{
+    pthread_mutex_lock(&bigint_stats_lock);
+
+    memset(bigint_stats_retired, 0, sizeof(bigint_stats_retired));
+
+    for (bigint_stats_block_t* block = bigint_stats_blocks; block != NULL; block = block->next) {
+        for (int i = 0; i < BIGINT_STATS; i++) {
+            atomic_store_explicit(&block->calls[i], 0, memory_order_relaxed);
+            atomic_store_explicit(&block->units[i], 0, memory_order_relaxed);
+            atomic_store_explicit(&block->nanoseconds[i], 0, memory_order_relaxed);
+        }
+    }
+
+    pthread_mutex_unlock(&bigint_stats_lock);
+}
+
+void bigint_stats_set_hook(bigint_stats_hook_t hook, void* data)
+{
+    atomic_store_explicit(&bigint_stats_hook_data, data, memory_order_relaxed);
+    atomic_store_explicit(&bigint_stats_hook, hook, memory_order_release);
+}
+
+#else
+
+bool bigint_stats_enabled(void)
+{
+    return false;
+}
+
+void bigint_stats_read(bigint_stat_value_t* values)
+{
+    memset(values, 0, BIGINT_STATS * sizeof(bigint_stat_value_t));
+}
+
+void bigint_stats_reset(void)
+{
+}
+
+void bigint_stats_set_hook(bigint_stats_hook_t hook, void* data)
+{
+    (void) hook;
+    (void) data;
+}
+
+#endif // BIGINT_STATS_ENABLED
@@ -0,0 +1,70 @@
+#include "bigint_tune.h"
+#include "bigint_tuned.h"
+#include "limb.h"
+
+#include<stdatomic.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+// From a bigint_tuned.h generated before this threshold existed.
+#ifndef BIGINT_TUNED_GCD_HALF
+#define BIGINT_TUNED_GCD_HALF 1024
+#endif
+
+typedef struct bigint_threshold_info_s
+{
+    const char* name;
+    size_t      minimum;
+} bigint_threshold_info_t;
+
+static const bigint_threshold_info_t bigint_threshold_info[BIGINT_THRESHOLDS] = {
+    { "MUL_KARATSUBA", LIMB_KARATSUBA_MIN + 1 },
+    { "SQR_KARATSUBA", LIMB_KARATSUBA_MIN + 1 },
+    { "RADIX_DC",      2                      },
+    { "GCD_HALF",      8                      },
+};
+
+static atomic_size_t bigint_thresholds[BIGINT_THRESHOLDS] = {
+    BIGINT_TUNED_MUL_KARATSUBA,
+    BIGINT_TUNED_SQR_KARATSUBA,
+    BIGINT_TUNED_RADIX_DC,
+    BIGINT_TUNED_GCD_HALF,
+};
+
+size_t bigint_threshold_get(bigint_threshold_t which)
+{
+    return atomic_load_explicit(&bigint_thresholds[which], memory_order_relaxed);
+}
+
+const char* bigint_threshold_name(bigint_threshold_t which)
+{
+    return bigint_threshold_info[which].name;
+}
+
+void bigint_threshold_set(bigint_threshold_t which, size_t value)
+{
+    if (value < bigint_threshold_info[which].minimum) {
+        value = bigint_threshold_info[which].minimum;
+    }
+    atomic_store_explicit(&bigint_thresholds[which], value, memory_order_relaxed);
+}
+
+// Runs before main, so the overrides are in place before anything computes.
+__attribute__((constructor))
+static void bigint_threshold_load_env(void)
+{
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        char variable[64];
+        snprintf(variable, sizeof(variable), "BIGINT_%s_THRESHOLD", bigint_threshold_info[i].name);
+
+        const char* value = getenv(variable);
+        char*       end;
+
+        if (value != NULL && *value != '\0') {
+            unsigned long long parsed = strtoull(value, &end, 10);
+            if (*end == '\0') {
+                bigint_threshold_set((bigint_threshold_t) i, (size_t) parsed);
+            }
+        }
+    }
+}
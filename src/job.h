@@ -0,0 +1,54 @@
+#ifndef JOB_H
+#define JOB_H
+
+// Progress and cancellation for the jobs in bigint_async.h. The kernels call
+// these at their recursion boundaries; outside of a job they only load a
+// thread local pointer.
+//
+//     if (job_cancelled()) {
+//         return false;
+//     }
+//     ...
+//     job_progress(JOB_WORK_MUL, an * bn);
+
+#include<stdatomic.h>
+#include<stdbool.h>
+#include<stdint.h>
+
+// What a job counts its progress in, everything else is left out.
+typedef enum job_work_e
+{
+    JOB_WORK_MUL = 0, // Limb products at the basecase, see limb_mul_work
+    JOB_WORK_DIGITS,  // Digits written out
+} job_work_t;
+
+typedef struct job_state_s
+{
+    job_work_t           work;
+    uint64_t             total; // Expected, may be a little off
+    atomic_uint_fast64_t done;
+    atomic_bool          cancelled;
+} job_state_t;
+
+// The job running on this thread, NULL when there's none.
+extern _Thread_local job_state_t* job_current;
+
+static inline void job_progress(job_work_t work, uint64_t units)
+{
+    job_state_t* job = job_current;
+
+    if (job != NULL && job->work == work) {
+        atomic_fetch_add_explicit(&job->done, units, memory_order_relaxed);
+    }
+}
+
+// Once true, whatever is being computed gets thrown away, callers may stop
+// anywhere and leave their output unfinished.
+static inline bool job_cancelled(void)
+{
+    job_state_t* job = job_current;
+
+    return job != NULL && atomic_load_explicit(&job->cancelled, memory_order_relaxed);
+}
+
+#endif // JOB_H
@@ -0,0 +1,447 @@
+#include "limb.h"
+#include "bigint_tune.h"
+#include "job.h"
+#include "stats.h"
+
+#include<string.h>
+
+size_t limb_leading_zeros(const uint32_t* a, size_t n)
+{
+    size_t zeros = 0;
+    while (zeros < n && a[zeros] == 0) {
+        zeros++;
+    }
+    return zeros;
+}
+
+int limb_cmp(const uint32_t* a, const uint32_t* b, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t limb_add(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn)
+{
+    uint64_t carry = 0;
+    size_t   i     = an;
+    size_t   j     = bn;
+
+    while (j > 0) {
+        carry += (uint64_t) a[--i] + b[--j];
+        r[i]   = (uint32_t) carry;
+        carry >>= 32;
+    }
+
+    while (i > 0) {
+        carry += a[--i];
+        r[i]   = (uint32_t) carry;
+        carry >>= 32;
+    }
+
+    return (uint32_t) carry;
+}
+
+uint32_t limb_sub(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn)
+{
+    uint32_t borrow = 0;
+    size_t   i      = an;
+    size_t   j      = bn;
+
+    while (j > 0) {
+        uint32_t x = a[--i];
+        uint32_t y = b[--j];
+        uint32_t d = x - y - borrow;
+        borrow     = (x < y) || (x == y && borrow);
+        r[i]       = d;
+    }
+
+    while (i > 0) {
+        uint32_t x = a[--i];
+        r[i]       = x - borrow;
+        borrow     = x < borrow;
+    }
+
+    return borrow;
+}
+
+uint32_t limb_mul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b)
+{
+    uint64_t carry = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        carry   += (uint64_t) a[i - 1] * b;
+        r[i - 1] = (uint32_t) carry;
+        carry  >>= 32;
+    }
+
+    return (uint32_t) carry;
+}
+
+uint32_t limb_addmul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b)
+{
+    uint64_t carry = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        carry   += (uint64_t) a[i - 1] * b + r[i - 1];
+        r[i - 1] = (uint32_t) carry;
+        carry  >>= 32;
+    }
+
+    return (uint32_t) carry;
+}
+
+uint32_t limb_submul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b)
+{
+    uint64_t borrow = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        uint64_t p   = (uint64_t) a[i - 1] * b + borrow;
+        uint32_t low = (uint32_t) p;
+
+        borrow   = (p >> 32) + (r[i - 1] < low);
+        r[i - 1] = r[i - 1] - low;
+    }
+
+    return (uint32_t) borrow;
+}
+
+void limb_mul_basecase(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn)
+{
+    size_t rn = an + bn;
+
+    if (an == 0 || bn == 0) {
+        memset(r, 0, rn * sizeof(uint32_t));
+        return;
+    }
+
+    // Row j (counting from the least significant limb of b) lands an limbs
+    // ending j limbs from the right, its carry just before that.
+    r[bn - 1] = limb_mul_1(r + bn, a, an, b[bn - 1]);
+    memset(r, 0, (bn - 1) * sizeof(uint32_t));
+
+    for (size_t j = 1; j < bn; j++) {
+        size_t start = rn - j - an;
+        r[start - 1] = limb_addmul_1(r + start, a, an, b[bn - 1 - j]);
+    }
+}
+
+void limb_sqr_basecase(uint32_t* r, const uint32_t* a, size_t n)
+{
+    size_t rn = 2 * n;
+
+    memset(r, 0, rn * sizeof(uint32_t));
+
+    // Products of distinct limbs, each pair once. Row i (from the least
+    // significant limb) multiplies the p = n - 1 - i limbs above a[p] by it
+    // and lands at index p + 1, its carry in the still empty r[p].
+    for (size_t p = n - 1; p > 0; p--) {
+        r[p] = limb_addmul_1(r + p + 1, a, p, a[p]);
+    }
+
+    // Twice that, plus the squares of every limb on the diagonal.
+    limb_lshift(r, r, rn, 1);
+
+    uint64_t carry = 0;
+    for (size_t i = n; i > 0; i--) {
+        uint64_t square = (uint64_t) a[i - 1] * a[i - 1];
+        size_t   low    = 2 * i - 1;
+
+        carry   += (uint64_t) r[low] + (uint32_t) square;
+        r[low]   = (uint32_t) carry;
+        carry  >>= 32;
+        carry   += (uint64_t) r[low - 1] + (square >> 32);
+        r[low - 1] = (uint32_t) carry;
+        carry  >>= 32;
+    }
+}
+
+// Adds carry into r[n], from the right, for as long as it carries.
+static void limb_incr(uint32_t* r, size_t n, uint32_t carry)
+{
+    while (carry != 0 && n > 0) {
+        r[n - 1] += carry;
+        carry     = r[n - 1] < carry;
+        n--;
+    }
+}
+
+size_t limb_mul_scratch(size_t n)
+{
+    // Mirrors limb_mul below, for the smallest threshold it accepts.
+    size_t total = 0;
+
+    while (n > LIMB_KARATSUBA_MIN) {
+        total += 2 * n + 6;
+        n      = n / 2 + 2;
+    }
+
+    return total;
+}
+
+uint64_t limb_mul_work(size_t an, size_t bn, bool square)
+{
+    if (an < bn) {
+        size_t t = an;
+        an = bn;
+        bn = t;
+    }
+
+    size_t threshold = bigint_threshold_get(square ? BIGINT_THRESHOLD_SQR_KARATSUBA : BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    if (bn < threshold || bn <= LIMB_KARATSUBA_MIN) {
+        return (uint64_t) an * bn;
+    }
+
+    size_t h = (an + 1) / 2;
+
+    if (bn <= h) {
+        uint64_t work = an / bn * limb_mul_work(bn, bn, false);
+        return an % bn == 0 ? work : work + limb_mul_work(bn, an % bn, false);
+    }
+
+    // Taking all three products as the largest keeps this linear.
+    return 3 * limb_mul_work(h + 1, h + 1, square);
+}
+
+void limb_mul(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn, uint32_t* scratch)
+{
+    if (an < bn) {
+        const uint32_t* t  = a;
+        size_t          tn = an;
+        a  = b;
+        an = bn;
+        b  = t;
+        bn = tn;
+    }
+
+    bool   square    = a == b && an == bn;
+    size_t threshold = bigint_threshold_get(square ? BIGINT_THRESHOLD_SQR_KARATSUBA : BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    if (bn < threshold || bn <= LIMB_KARATSUBA_MIN) {
+        if (square) {
+            BIGINT_COUNT(BIGINT_STAT_SQR_BASECASE, an + bn);
+            limb_sqr_basecase(r, a, an);
+        } else {
+            BIGINT_COUNT(BIGINT_STAT_MUL_BASECASE, an + bn);
+            limb_mul_basecase(r, a, an, b, bn);
+        }
+        job_progress(JOB_WORK_MUL, (uint64_t) an * bn);
+        return;
+    }
+
+    if (job_cancelled()) {
+        return;
+    }
+
+    size_t rn = an + bn;
+    size_t h  = (an + 1) / 2;
+
+    if (bn <= h) {
+        // Too unbalanced to split evenly, multiply b by bn limb slices of a
+        // from the least significant end.
+        uint32_t* t = scratch;
+
+        memset(r, 0, rn * sizeof(uint32_t));
+
+        for (size_t done = 0; done < an && !job_cancelled(); done += bn) {
+            size_t cn  = an - done < bn ? an - done : bn;
+            size_t end = rn - done;
+
+            limb_mul(t, b, bn, a + an - done - cn, cn, scratch + 2 * bn);
+            limb_incr(r, end - cn - bn, limb_add(r + end - cn - bn, r + end - cn - bn, cn + bn, t, cn + bn));
+        }
+        return;
+    }
+
+    BIGINT_COUNT(square ? BIGINT_STAT_SQR_KARATSUBA : BIGINT_STAT_MUL_KARATSUBA, an + bn);
+
+    // Karatsuba: with a = a1 B^h + a0 and b = b1 B^h + b0,
+    //   a b = z2 B^2h + (z1 - z2 - z0) B^h + z0
+    // where z2 = a1 b1, z0 = a0 b0 and z1 = (a0 + a1)(b0 + b1). z2 and z0
+    // fill r exactly, the middle term is added on top.
+    const uint32_t* a0 = a + an - h;
+    const uint32_t* b0 = b + bn - h;
+    size_t          a1n = an - h;
+    size_t          b1n = bn - h;
+
+    uint32_t* z1   = scratch;
+    uint32_t* sa   = z1 + 2 * h + 2;
+    uint32_t* sb   = sa + h + 1;
+    uint32_t* next = sb + h + 1;
+
+    limb_mul(r + rn - 2 * h, a0, h, b0, h, next);
+    limb_mul(r, a, a1n, b, b1n, next);
+
+    sa[0] = limb_add(sa + 1, a0, h, a, a1n);
+    if (square) {
+        limb_mul(z1, sa, h + 1, sa, h + 1, next);
+    } else {
+        sb[0] = limb_add(sb + 1, b0, h, b, b1n);
+        limb_mul(z1, sa, h + 1, sb, h + 1, next);
+    }
+
+    limb_sub(z1, z1, 2 * h + 2, r + rn - 2 * h, 2 * h);
+    limb_sub(z1, z1, 2 * h + 2, r, a1n + b1n);
+
+    // The middle term is below B^(rn - h), so only its low limbs matter.
+    size_t top = rn - h;
+    size_t zn  = 2 * h + 2 < top ? 2 * h + 2 : top;
+    limb_add(r, r, top, z1 + 2 * h + 2 - zn, zn);
+}
+
+uint32_t limb_divmod_1(uint32_t* q, const uint32_t* a, size_t n, uint32_t d)
+{
+    uint64_t rem = 0;
+
+    BIGINT_COUNT(BIGINT_STAT_DIV_1, n);
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = (rem << 32) | a[i];
+        if (q != NULL) {
+            q[i] = (uint32_t) (t / d);
+        }
+        rem = t % d;
+    }
+
+    return (uint32_t) rem;
+}
+
+size_t limb_divmod_scratch(size_t an, size_t dn)
+{
+    return dn > 1 ? an + 1 + dn + an - dn + 1 : 0;
+}
+
+void limb_divmod(uint32_t* q, uint32_t* r, const uint32_t* a, size_t an, const uint32_t* d, size_t dn, uint32_t* scratch)
+{
+    if (dn == 1) {
+        uint32_t rem = limb_divmod_1(q, a, an, d[0]);
+        if (r != NULL) {
+            r[0] = rem;
+        }
+        return;
+    }
+
+    BIGINT_COUNT(BIGINT_STAT_DIV_KNUTH, an);
+
+    // Knuth's algorithm D, run on little endian copies of the operands
+    // normalized so the divisor's top bit is set.
+    size_t    qn = an - dn + 1;
+    uint32_t* un = scratch;
+
+    uint32_t* vn = un + an + 1;
+    uint32_t* qs = vn + dn;
+    unsigned  s  = (unsigned) __builtin_clz(d[0]);
+
+    // Limb i takes the top bits of limb i - 1, the one below it.
+    for (size_t i = 0; i < dn; i++) {
+        uint32_t x     = d[dn - 1 - i];
+        uint32_t below = i > 0 ? d[dn - i] : 0;
+        vn[i] = s == 0 ? x : (x << s) | (below >> (32 - s));
+    }
+
+    un[an] = s == 0 ? 0 : a[0] >> (32 - s);
+    for (size_t i = 0; i < an; i++) {
+        uint32_t x     = a[an - 1 - i];
+        uint32_t below = i > 0 ? a[an - i] : 0;
+        un[i] = s == 0 ? x : (x << s) | (below >> (32 - s));
+    }
+
+    uint64_t top    = vn[dn - 1];
+    uint64_t second = vn[dn - 2];
+
+    // Long divisions check for cancelled jobs once per quotient limb.
+    for (size_t j = qn; j-- > 0 && !job_cancelled();) {
+        uint64_t num  = ((uint64_t) un[j + dn] << 32) | un[j + dn - 1];
+        uint64_t qhat = num / top;
+        uint64_t rhat = num % top;
+
+        while (qhat > 0xFFFFFFFFu || qhat * second > ((rhat << 32) | un[j + dn - 2])) {
+            qhat--;
+            rhat += top;
+            if (rhat > 0xFFFFFFFFu) {
+                break;
+            }
+        }
+
+        // un[j .. j + dn] -= qhat * vn
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < dn; i++) {
+            uint64_t p   = qhat * vn[i] + borrow;
+            uint32_t low = (uint32_t) p;
+            borrow     = (p >> 32) + (un[i + j] < low);
+            un[i + j] -= low;
+        }
+
+        bool negative = un[j + dn] < borrow;
+        un[j + dn]   -= (uint32_t) borrow;
+
+        // qhat was one too many, add the divisor back.
+        if (negative) {
+            uint64_t carry = 0;
+            qhat--;
+            for (size_t i = 0; i < dn; i++) {
+                carry    += (uint64_t) un[i + j] + vn[i];
+                un[i + j] = (uint32_t) carry;
+                carry   >>= 32;
+            }
+            un[j + dn] += (uint32_t) carry;
+        }
+
+        qs[j] = (uint32_t) qhat;
+    }
+
+    if (q != NULL) {
+        for (size_t i = 0; i < qn; i++) {
+            q[i] = qs[qn - 1 - i];
+        }
+    }
+
+    if (r != NULL) {
+        for (size_t i = 0; i < dn; i++) {
+            uint32_t lo = un[i];
+            uint32_t hi = un[i + 1];
+            r[dn - 1 - i] = s == 0 ? lo : (lo >> s) | (hi << (32 - s));
+        }
+    }
+
+}
+
+uint32_t limb_lshift(uint32_t* r, const uint32_t* a, size_t n, unsigned bits)
+{
+    if (bits == 0) {
+        memmove(r, a, n * sizeof(uint32_t));
+        return 0;
+    }
+
+    uint32_t out = 0;
+
+    for (size_t i = n; i > 0; i--) {
+        uint32_t x = a[i - 1];
+        r[i - 1]   = (x << bits) | out;
+        out        = x >> (32 - bits);
+    }
+
+    return out;
+}
+
+uint32_t limb_rshift(uint32_t* r, const uint32_t* a, size_t n, unsigned bits)
+{
+    if (bits == 0) {
+        memmove(r, a, n * sizeof(uint32_t));
+        return 0;
+    }
+
+    uint32_t out = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = a[i];
+        r[i]       = (x >> bits) | out;
+        out        = x << (32 - bits);
+    }
+
+    return out;
+}
@@ -0,0 +1,65 @@
+#ifndef LIMB_H
+#define LIMB_H
+
+// Low level kernels over raw limb vectors, used by the bigint_* functions.
+//
+// Vectors use the same layout as bigint_t: most significant limb first, so
+// operands of different lengths line up on their right ends. None of these
+// allocate or check for leading zeroes unless stated otherwise.
+
+#include<stdbool.h>
+#include<stddef.h>
+#include<stdint.h>
+
+// Number of zero limbs at the front of a.
+size_t   limb_leading_zeros(const uint32_t* a, size_t n);
+
+int      limb_cmp(const uint32_t* a, const uint32_t* b, size_t n);
+
+// r[an] = a[an] + b[bn], with an >= bn. Returns the carry. r may be a or b.
+uint32_t limb_add(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn);
+
+// r[an] = a[an] - b[bn], with an >= bn. Returns the borrow. r may be a or b.
+uint32_t limb_sub(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn);
+
+// r[n] = a[n] * b, returns the high limb. r may be a.
+uint32_t limb_mul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+
+// r[n] += a[n] * b, returns the high limb.
+uint32_t limb_addmul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+
+// r[n] -= a[n] * b, returns the high limb of what couldn't be subtracted.
+uint32_t limb_submul_1(uint32_t* r, const uint32_t* a, size_t n, uint32_t b);
+
+// r[an + bn] = a[an] * b[bn] and r[2n] = a[n]^2, schoolbook. r must not
+// overlap the operands.
+void     limb_mul_basecase(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn);
+void     limb_sqr_basecase(uint32_t* r, const uint32_t* a, size_t n);
+
+// Karatsuba never splits operands this short, whatever the thresholds say.
+#define LIMB_KARATSUBA_MIN 4
+
+// r[an + bn] = a[an] * b[bn], switching to Karatsuba above the thresholds in
+// bigint_tune.h, and to squaring when a and b are the same vector. r must not
+// overlap the operands. scratch holds limb_mul_scratch(max(an, bn)) limbs.
+size_t   limb_mul_scratch(size_t n);
+void     limb_mul(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn, uint32_t* scratch);
+
+// Roughly how many limb products limb_mul does at its basecase, the units of
+// its job progress.
+uint64_t limb_mul_work(size_t an, size_t bn, bool square);
+
+// q[n] = a[n] / d, returns the remainder. q may be a or NULL.
+uint32_t limb_divmod_1(uint32_t* q, const uint32_t* a, size_t n, uint32_t d);
+
+// q[an - dn + 1] = a[an] / d[dn] and r[dn] = a[an] % d[dn], for an >= dn and a
+// d without leading zeroes. Either q or r may be NULL. scratch holds
+// limb_divmod_scratch(an, dn) limbs for the working copies.
+size_t   limb_divmod_scratch(size_t an, size_t dn);
+void     limb_divmod(uint32_t* q, uint32_t* r, const uint32_t* a, size_t an, const uint32_t* d, size_t dn, uint32_t* scratch);
+
+// r[n] = a[n] << bits or >> bits, with bits < 32. Returns the bits shifted out.
+uint32_t limb_lshift(uint32_t* r, const uint32_t* a, size_t n, unsigned bits);
+uint32_t limb_rshift(uint32_t* r, const uint32_t* a, size_t n, unsigned bits);
+
+#endif // LIMB_H
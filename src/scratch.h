@@ -0,0 +1,31 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+// The per thread limb stack behind bigint_scratch.h. Frames are popped in
+// the reverse order they were pushed:
+//
+//     scratch_frame_t frame;
+//     uint32_t*       t = scratch_push(&frame, n + limb_mul_scratch(n));
+//     ...
+//     scratch_pop(&frame);
+//
+// Only a push on an empty stack grows it, since frames below hold pointers
+// into it. A nested push that doesn't fit gets its own allocation instead,
+// so the outermost call should ask for everything its callees will take.
+
+#include<stddef.h>
+#include<stdint.h>
+
+typedef struct scratch_frame_s
+{
+    size_t    mark;
+    size_t    size;
+    uint32_t* heap; // When it didn't fit
+} scratch_frame_t;
+
+// n limbs, never NULL unless out of memory, even for n = 0. Popping a frame
+// whose push failed does nothing.
+uint32_t* scratch_push(scratch_frame_t* frame, size_t n);
+void      scratch_pop(scratch_frame_t* frame);
+
+#endif // SCRATCH_H
@@ -0,0 +1,39 @@
+#ifndef STATS_H
+#define STATS_H
+
+// Counting for bigint_stats.h. Without BIGINT_STATS_ENABLED, which the
+// BIGINT_STATS CMake option sets, these expand to nothing and their arguments
+// are never evaluated.
+//
+//     BIGINT_TIME_BEGIN(BIGINT_STAT_MUL, timer, an + bn);
+//     ...
+//     BIGINT_TIME_END(timer);
+
+#include "bigint_stats.h"
+
+#ifdef BIGINT_STATS_ENABLED
+
+typedef struct bigint_stats_timer_s
+{
+    bigint_stat_t stat;
+    uint64_t      units;
+    uint64_t      start;
+} bigint_stats_timer_t;
+
+void                 bigint_stats_count(bigint_stat_t stat, uint64_t units);
+bigint_stats_timer_t bigint_stats_begin(bigint_stat_t stat, uint64_t units);
+void                 bigint_stats_end(bigint_stats_timer_t* timer);
+
+#define BIGINT_COUNT(stat, units)             bigint_stats_count((stat), (uint64_t) (units))
+#define BIGINT_TIME_BEGIN(stat, timer, units) bigint_stats_timer_t timer = bigint_stats_begin((stat), (uint64_t) (units))
+#define BIGINT_TIME_END(timer)                bigint_stats_end(&(timer))
+
+#else
+
+#define BIGINT_COUNT(stat, units)             ((void) 0)
+#define BIGINT_TIME_BEGIN(stat, timer, units) ((void) 0)
+#define BIGINT_TIME_END(timer)                ((void) 0)
+
+#endif // BIGINT_STATS_ENABLED
+
+#endif // STATS_H
@@ -272,6 +272,52 @@ START_TEST(test_array_push_and_pop_front)
 }
 END_TEST
 
+START_TEST(test_array_share)
+{
+    array_t* a = ARRAY_NEW(uint32_t);
+    uint32_t one = 1;
+    uint32_t two = 2;
+
+    ck_assert(ARRAY_RESIZE(a, 10));
+    array_set(a, 0, &one);
+
+    array_t* b = array_share(a);
+    ck_assert(b != NULL);
+    ck_assert(b->items == a->items); // Should not have copied
+    ck_assert(b->size  == a->size);
+    ck_assert(array_is_shared(a));
+    ck_assert(array_is_shared(b));
+
+    // Writing to b should copy, leaving a untouched
+    ck_assert(array_set(b, 0, &two));
+    ck_assert(b->items != a->items);
+    ck_assert(*((uint32_t*) array_get(a, 0)) == 1);
+    ck_assert(*((uint32_t*) array_get(b, 0)) == 2);
+    ck_assert(!array_is_shared(a));
+    ck_assert(!array_is_shared(b));
+
+    // Last owner of a shared buffer should not copy on write
+    array_t* c = array_share(a);
+    uint8_t* old_items = a->items;
+    array_delete(c);
+    ck_assert(array_set(a, 1, &two));
+    ck_assert(a->items == old_items);
+    ck_assert(a->refcount == NULL);
+
+    // Resizing also unshares
+    c = array_share(a);
+    ck_assert(ARRAY_RESIZE(c, 12));
+    ck_assert(c->items != a->items);
+    ck_assert(a->size == 10);
+    ck_assert(c->size == 12);
+    ck_assert(memcmp(a->items, c->items, 10 * sizeof(uint32_t)) == 0);
+
+    array_delete(a);
+    array_delete(b);
+    array_delete(c);
+}
+END_TEST
+
 Suite* array_suite(void)
 {
     Suite* s;
@@ -286,6 +332,7 @@ Suite* array_suite(void)
     tcase_add_test(tc_core, test_array_equals);
     tcase_add_test(tc_core, test_array_push_and_pop_back);
     tcase_add_test(tc_core, test_array_push_and_pop_front);
+    tcase_add_test(tc_core, test_array_share);
     suite_add_tcase(s, tc_core);
 
     return s;
@@ -57,6 +57,265 @@ START_TEST(test_bigint_resize)
 }
 END_TEST
 
+START_TEST(test_bigint_share)
+{
+    bigint_t* number = bigint_new();
+    bigint_setbit(number, 40, 1);
+    ck_assert(number->size == 2);
+
+    bigint_t* copy = bigint_share(number);
+    ck_assert(copy != NULL);
+    ck_assert(copy->items == number->items); // O(1), no copy yet
+    ck_assert(bigint_equals(number, copy));
+    ck_assert(copy->items == number->items); // Comparing doesn't unshare
+
+    bigint_setbit(copy, 0, 1);
+    ck_assert(copy->items != number->items); // Copied on write
+    ck_assert( bigint_getbit(copy,   0));
+    ck_assert(!bigint_getbit(number, 0));
+    ck_assert( bigint_getbit(number, 40));
+    ck_assert(!bigint_equals(number, copy));
+
+    bigint_delete(number);
+    bigint_delete(copy);
+}
+END_TEST
+
+START_TEST(test_bigint_wrap)
+{
+    uint32_t  limbs[3] = { 0, 0x00000001, 0x80000000 };
+    bigint_t  view;
+
+    bigint_wrap(&view, limbs, 3);
+    ck_assert(view.items == (uint8_t*) limbs); // No copy
+    ck_assert(bigint_getbit(&view, 31));
+    ck_assert(bigint_getbit(&view, 32));
+
+    size_t count;
+    const uint32_t* used = bigint_limbs(&view, &count);
+    ck_assert(count == 2);           // Leading zero skipped
+    ck_assert(used  == &limbs[1]);   // Still pointing at the caller memory
+
+    // Equal to the trimmed value, and left as it was
+    bigint_t* trimmed = bigint_new();
+    bigint_setbit(trimmed, 31, 1);
+    bigint_setbit(trimmed, 32, 1);
+    ck_assert(bigint_equals(&view, trimmed));
+    ck_assert(bigint_equals(trimmed, &view));
+    ck_assert(view.items == (uint8_t*) limbs && view.size == 3);
+    ck_assert(trimmed->size == 2);
+    bigint_delete(trimmed);
+
+    // Writing copies first, the caller memory must stay untouched
+    bigint_setbit(&view, 0, 1);
+    ck_assert(view.items != (uint8_t*) limbs);
+    ck_assert(bigint_getbit(&view, 0));
+    ck_assert(limbs[2] == 0x80000000);
+
+    bigint_release(&view);
+    ck_assert(view.items == NULL);
+}
+END_TEST
+
+START_TEST(test_bigint_import_and_export)
+{
+    // 0x0102030405060708090A as big endian bytes
+    uint8_t bytes[10] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A };
+    uint8_t out[16];
+    size_t  count;
+
+    bigint_t* number = bigint_new();
+    ck_assert(bigint_import(number, 10, 1, 1, 0, 0, bytes));
+
+    size_t used;
+    const uint32_t* limbs = bigint_limbs(number, &used);
+    ck_assert(used == 3);
+    ck_assert(limbs[0] == 0x00000102);
+    ck_assert(limbs[1] == 0x03040506);
+    ck_assert(limbs[2] == 0x0708090A);
+
+    // Back to bytes
+    memset(out, 0, sizeof(out));
+    ck_assert(bigint_export(out, &count, 1, 1, 0, 0, number) == out);
+    ck_assert(count == 10);
+    ck_assert(memcmp(out, bytes, 10) == 0);
+
+    // Little endian 16-bit words, least significant first
+    ck_assert(bigint_export(out, &count, -1, 2, -1, 0, number) == out);
+    ck_assert(count == 5);
+    for (size_t i = 0; i < 10; i++) {
+        ck_assert(out[i] == bytes[9 - i]);
+    }
+
+    bigint_t* other = bigint_new();
+    ck_assert(bigint_import(other, 5, -1, 2, -1, 0, out));
+    ck_assert(bigint_equals(number, other));
+
+    // Big endian 32-bit words with 4 nail bits, then back
+    ck_assert(bigint_export(out, &count, 1, 4, 1, 4, number) == out);
+    ck_assert(count == 3); // 73 bits in 28-bit words
+    for (size_t i = 0; i < count; i++) {
+        ck_assert((out[i * 4] & 0xF0) == 0); // Nails should be zero
+    }
+    ck_assert(bigint_import(other, count, 1, 4, 1, 4, out));
+    ck_assert(bigint_equals(number, other));
+
+    // Allocating export
+    uint32_t* native = bigint_export(NULL, &count, 1, sizeof(uint32_t), 0, 0, number);
+    ck_assert(native != NULL);
+    ck_assert(count == 3);
+    ck_assert(memcmp(native, limbs, 3 * sizeof(uint32_t)) == 0);
+    free(native);
+
+    bigint_delete(number);
+    bigint_delete(other);
+}
+END_TEST
+
+START_TEST(test_bigint_mul_and_divmod)
+{
+    bigint_t* a = bigint_new();
+    bigint_t* b = bigint_new();
+    bigint_t* c = bigint_new();
+    bigint_t* r = bigint_new();
+
+    // Small values against native arithmetic
+    ck_assert(bigint_set_u64(a, 0xFFFFFFFFull));
+    ck_assert(bigint_set_u64(b, 0xFFFFFFFFull));
+    ck_assert(bigint_mul(c, a, b));
+    ck_assert(c->size == 2);
+    ck_assert(bigint_get_u64(c) == 0xFFFFFFFE00000001ull);
+
+    ck_assert(bigint_set_u64(a, 0x123456789ABCDEFull));
+    uint32_t rem;
+    ck_assert(bigint_divmod_u32(c, &rem, a, 1000));
+    ck_assert(bigint_get_u64(c) == 0x123456789ABCDEFull / 1000);
+    ck_assert(rem == 0x123456789ABCDEFull % 1000);
+    ck_assert(!bigint_divmod_u32(c, &rem, a, 0)); // Division by zero
+
+    // Random operands: (a * b) / b == a and (a * b + r) / b leaves r
+    for (size_t n = 1; n < 40; n += 3) {
+        bigint_resize(a, n);
+        bigint_resize(b, n / 2 + 1);
+        for (size_t i = 0; i < a->size; i++) {
+            uint32_t x = (uint32_t) rand() * 2654435761u;
+            array_set(a, i, &x);
+        }
+        for (size_t i = 0; i < b->size; i++) {
+            uint32_t x = (uint32_t) rand() * 2246822519u | 1;
+            array_set(b, i, &x);
+        }
+
+        ck_assert(bigint_mul(c, a, b));
+        ck_assert(bigint_bitlen(c) >= bigint_bitlen(a) + bigint_bitlen(b) - 1);
+
+        ck_assert(bigint_divmod(c, r, c, b)); // Quotient aliasing the dividend
+        ck_assert(bigint_is_zero(r));
+        ck_assert(bigint_cmp(c, a) == 0);
+
+        ck_assert(bigint_mul_u32(c, a, 3));
+        ck_assert(bigint_divmod(c, NULL, c, a));
+        ck_assert(bigint_get_u64(c) == 3);
+    }
+
+    // Dividing by something bigger leaves everything in the remainder
+    ck_assert(bigint_divmod(c, r, b, a));
+    ck_assert(bigint_is_zero(c));
+    ck_assert(bigint_cmp(r, b) == 0);
+
+    ck_assert(bigint_set_u32(b, 0));
+    ck_assert(!bigint_divmod(c, r, a, b)); // Division by zero
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(c);
+    bigint_delete(r);
+}
+END_TEST
+
+START_TEST(test_bigint_add_sub_and_shift)
+{
+    bigint_t* a = bigint_new();
+    bigint_t* b = bigint_new();
+    bigint_t* c = bigint_new();
+
+    // Carry all the way through
+    bigint_resize(a, 4);
+    for (size_t i = 0; i < 4; i++) {
+        uint32_t ones = 0xFFFFFFFF;
+        array_set(a, i, &ones);
+    }
+    ck_assert(bigint_add_u32(c, a, 1));
+    ck_assert(c->size == 5);
+    ck_assert(bigint_bitlen(c) == 129);
+    ck_assert(bigint_getbit(c, 128));
+
+    // And the borrow back
+    ck_assert(bigint_sub_u32(c, c, 1));
+    ck_assert(bigint_cmp(c, a) == 0);
+    ck_assert(!bigint_sub(c, b, a)); // Would be negative
+
+    // Aliasing either side
+    ck_assert(bigint_set_u64(b, 12345));
+    ck_assert(bigint_add(b, a, b));
+    ck_assert(bigint_sub(b, b, a));
+    ck_assert(bigint_get_u64(b) == 12345);
+    ck_assert(bigint_sub(a, a, a));
+    ck_assert(bigint_is_zero(a));
+
+    // Shifts
+    ck_assert(bigint_shl(c, b, 100));
+    ck_assert(bigint_bitlen(c) == bigint_bitlen(b) + 100);
+    ck_assert(bigint_shr(c, c, 100));
+    ck_assert(bigint_get_u64(c) == 12345);
+    ck_assert(bigint_shr(c, c, 3));
+    ck_assert(bigint_get_u64(c) == 12345 >> 3);
+    ck_assert(bigint_shr(c, c, 1000));
+    ck_assert(bigint_is_zero(c));
+
+    // 3^40 doesn't fit 64 bits, 3^40 / 3^20 does
+    ck_assert(bigint_set_u32(a, 3));
+    ck_assert(bigint_pow_u32(b, a, 40));
+    ck_assert(bigint_pow_u32(c, a, 20));
+    ck_assert(bigint_divmod(b, NULL, b, c));
+    ck_assert(bigint_get_u64(b) == 3486784401ull);
+    ck_assert(bigint_pow_u32(c, a, 0));
+    ck_assert(bigint_get_u64(c) == 1);
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(c);
+}
+END_TEST
+
+START_TEST(test_bigint_inline)
+{
+    bigint_t* a = bigint_new();
+
+    ck_assert(bigint_limb(a, 0) == 0);
+    ck_assert(bigint_is_u32(a));
+    ck_assert_int_eq(bigint_cmp_u32(a, 0), 0);
+    ck_assert_int_eq(bigint_cmp_u32(a, 1), -1);
+
+    ck_assert(bigint_set_u64(a, 0x123456789ull));
+    ck_assert(bigint_limb(a, 0) == 0x23456789);
+    ck_assert(bigint_limb(a, 1) == 1);
+    ck_assert(bigint_limb(a, 2) == 0);
+    ck_assert(!bigint_is_u32(a));
+    ck_assert_int_eq(bigint_cmp_u32(a, 0xFFFFFFFF), 1);
+
+    // Leading zero limbs don't count
+    ck_assert(bigint_set_u32(a, 7));
+    bigint_resize(a, 3);
+    ck_assert(bigint_is_u32(a));
+    ck_assert_int_eq(bigint_cmp_u32(a, 7), 0);
+    ck_assert_int_eq(bigint_cmp_u32(a, 8), -1);
+    ck_assert_int_eq(bigint_cmp_u32(a, 6), 1);
+
+    bigint_delete(a);
+}
+END_TEST
+
 Suite* bigint_suite(void)
 {
     Suite* s;
@@ -67,6 +326,12 @@ Suite* bigint_suite(void)
     tc_core = tcase_create("Core");
     tcase_add_test(tc_core, test_bigint_create_and_delete);
     tcase_add_test(tc_core, test_bigint_resize);
+    tcase_add_test(tc_core, test_bigint_share);
+    tcase_add_test(tc_core, test_bigint_wrap);
+    tcase_add_test(tc_core, test_bigint_import_and_export);
+    tcase_add_test(tc_core, test_bigint_mul_and_divmod);
+    tcase_add_test(tc_core, test_bigint_add_sub_and_shift);
+    tcase_add_test(tc_core, test_bigint_inline);
     suite_add_tcase(s, tc_core);
 
     return s;
@@ -0,0 +1,240 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_accumulator.h>
+#include<bigint_tune.h>
+
+#include "random.h"
+
+Suite* bigint_accumulator_suite(void);
+
+// Mostly short values, with a long one now and then.
+static size_t random_size(void)
+{
+    switch (rand() % 8) {
+        case 0:  return 0;
+        case 1:  return 20 + (size_t) rand() % 60;
+        case 2:  return 100 + (size_t) rand() % 200;
+        default: return 1 + (size_t) rand() % 4;
+    }
+}
+
+START_TEST(test_bigint_accumulator_sum)
+{
+    bigint_accumulator_t acc;
+    ck_assert(bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_SUM));
+
+    bigint_t* expected = bigint_new();
+    bigint_t* result   = bigint_new();
+
+    for (int round = 0; round < 3; round++) {
+        bigint_set_u32(expected, 0);
+
+        for (int i = 0; i < 500; i++) {
+            bigint_t* value = random_number(random_size());
+
+            ck_assert(bigint_accumulator_push(&acc, value));
+            ck_assert(bigint_add(expected, expected, value));
+            bigint_delete(value);
+
+            uint32_t small = (uint32_t) rand();
+            ck_assert(bigint_accumulator_push_u32(&acc, small));
+            ck_assert(bigint_add_u32(expected, expected, small));
+        }
+
+        // Used again after every finish
+        ck_assert(bigint_accumulator_finish(&acc, result));
+        ck_assert(bigint_cmp(result, expected) == 0);
+        ck_assert_uint_eq(acc.count, 0);
+    }
+
+    // Carries all the way up
+    bigint_t* ones = bigint_new();
+    bigint_resize(ones, 10);
+    for (size_t i = 0; i < 10; i++) {
+        uint32_t r = 0xFFFFFFFFu;
+        array_set(ones, i, &r);
+    }
+
+    ck_assert(bigint_accumulator_push(&acc, ones));
+    ck_assert(bigint_accumulator_push_u32(&acc, 1));
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    ck_assert(bigint_add_u32(ones, ones, 1));
+    ck_assert(bigint_cmp(result, ones) == 0);
+
+    // At the limit the carries go up before the next value is added
+    ck_assert(bigint_accumulator_push(&acc, ones));
+    acc.pending = UINT32_MAX;
+    ck_assert(bigint_accumulator_push(&acc, ones));
+    ck_assert_uint_eq(acc.pending, 1);
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    ck_assert(bigint_add(ones, ones, ones));
+    ck_assert(bigint_cmp(result, ones) == 0);
+
+    bigint_delete(ones);
+    bigint_delete(expected);
+    bigint_delete(result);
+    bigint_accumulator_free(&acc);
+}
+END_TEST
+
+START_TEST(test_bigint_accumulator_product)
+{
+    bigint_accumulator_t acc;
+    ck_assert(bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_PRODUCT));
+
+    bigint_t* expected = bigint_new();
+    bigint_t* result   = bigint_new();
+
+    for (int round = 0; round < 3; round++) {
+        bigint_set_u32(expected, 1);
+
+        for (int i = 0; i < 200; i++) {
+            size_t    size  = random_size();
+            bigint_t* value = random_number(size == 0 ? 1 : size);
+
+            ck_assert(bigint_accumulator_push(&acc, value));
+            ck_assert(bigint_mul(expected, expected, value));
+            bigint_delete(value);
+
+            uint32_t small = (uint32_t) rand() | 1;
+            ck_assert(bigint_accumulator_push_u32(&acc, small));
+            ck_assert(bigint_mul_u32(expected, expected, small));
+        }
+
+        ck_assert(bigint_accumulator_finish(&acc, result));
+        ck_assert(bigint_cmp(result, expected) == 0);
+    }
+
+    bigint_delete(expected);
+    bigint_delete(result);
+    bigint_accumulator_free(&acc);
+}
+END_TEST
+
+START_TEST(test_bigint_accumulator_factorial)
+{
+    size_t karatsuba = bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    bigint_t* expected = bigint_new();
+    bigint_t* result   = bigint_new();
+
+    // With the leaf as short as it goes, too
+    for (size_t threshold = 0; threshold < 2; threshold++) {
+        if (threshold == 1) {
+            bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 0);
+        }
+
+        bigint_accumulator_t acc;
+        ck_assert(bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_PRODUCT));
+
+        bigint_set_u32(expected, 1);
+        for (uint32_t i = 1; i <= 3000; i++) {
+            ck_assert(bigint_accumulator_push_u32(&acc, i));
+            ck_assert(bigint_mul_u32(expected, expected, i));
+        }
+
+        ck_assert_uint_eq(acc.count, 3000);
+        ck_assert(bigint_accumulator_finish(&acc, result));
+        ck_assert(bigint_cmp(result, expected) == 0);
+
+        // Finishing empties the levels
+        ck_assert(acc.levels->size == 0);
+
+        bigint_accumulator_free(&acc);
+    }
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, karatsuba);
+
+    bigint_delete(expected);
+    bigint_delete(result);
+}
+END_TEST
+
+START_TEST(test_bigint_accumulator_empty)
+{
+    bigint_accumulator_t acc;
+    bigint_t*            result = bigint_new();
+    bigint_t*            zero   = bigint_new();
+    bigint_t*            one    = bigint_new();
+
+    bigint_set_u32(result, 7);
+    ck_assert(bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_SUM));
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    ck_assert(bigint_is_zero(result));
+
+    // Zeros add nothing
+    ck_assert(bigint_accumulator_push(&acc, zero));
+    ck_assert(bigint_accumulator_push_u32(&acc, 0));
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    ck_assert(bigint_is_zero(result));
+    bigint_accumulator_free(&acc);
+
+    ck_assert(bigint_accumulator_init(&acc, BIGINT_ACCUMULATE_PRODUCT));
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    bigint_set_u32(one, 1);
+    ck_assert(bigint_cmp(result, one) == 0);
+
+    // But one zero is enough for a product
+    bigint_t* big = random_number(300);
+    ck_assert(bigint_accumulator_push(&acc, big));
+    ck_assert(bigint_accumulator_push(&acc, zero));
+    ck_assert(bigint_accumulator_push(&acc, big));
+    ck_assert(bigint_accumulator_finish(&acc, result));
+    ck_assert(bigint_is_zero(result));
+
+    // The result can be one of the values pushed
+    ck_assert(bigint_accumulator_push(&acc, big));
+    ck_assert(bigint_accumulator_push_u32(&acc, 2));
+    bigint_t* expected = bigint_new();
+    ck_assert(bigint_mul_u32(expected, big, 2));
+    ck_assert(bigint_accumulator_finish(&acc, big));
+    ck_assert(bigint_cmp(big, expected) == 0);
+
+    bigint_delete(expected);
+    bigint_delete(big);
+    bigint_accumulator_free(&acc);
+
+    bigint_delete(result);
+    bigint_delete(zero);
+    bigint_delete(one);
+}
+END_TEST
+
+Suite* bigint_accumulator_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntAccumulator");
+
+    tc_core = tcase_create("Core");
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_test(tc_core, test_bigint_accumulator_sum);
+    tcase_add_test(tc_core, test_bigint_accumulator_product);
+    tcase_add_test(tc_core, test_bigint_accumulator_factorial);
+    tcase_add_test(tc_core, test_bigint_accumulator_empty);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_accumulator_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
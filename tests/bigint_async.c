@@ -0,0 +1,216 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<string.h>
+#include<time.h>
+#include<bigint_async.h>
+#include<bigint_io.h>
+
+#include "random.h"
+
+Suite* bigint_async_suite(void);
+
+START_TEST(test_bigint_async_mul)
+{
+    bigint_job_t* jobs[8];
+    bigint_t*     expected[8];
+
+    // A few at once, operands changed and deleted as soon as they're in
+    for (size_t i = 0; i < 8; i++) {
+        bigint_t* a = random_number(1 + (size_t) rand() % 2000);
+        bigint_t* b = i % 4 == 0 ? a : random_number(1 + (size_t) rand() % 2000);
+
+        expected[i] = bigint_new();
+        ck_assert(bigint_mul(expected[i], a, b));
+
+        jobs[i] = bigint_mul_async(a, b);
+        ck_assert(jobs[i] != NULL);
+
+        ck_assert(bigint_add_u32(a, a, 1));
+        if (b != a) {
+            bigint_delete(b);
+        }
+        bigint_delete(a);
+    }
+
+    bigint_t* result = bigint_new();
+
+    for (size_t i = 0; i < 8; i++) {
+        ck_assert_int_eq(bigint_job_wait(jobs[i]), BIGINT_JOB_DONE);
+        ck_assert(bigint_job_progress(jobs[i]) == 1.0);
+        ck_assert(bigint_job_string(jobs[i]) == NULL);
+
+        // Handed over once
+        ck_assert(bigint_job_result(jobs[i], result));
+        ck_assert(bigint_cmp(result, expected[i]) == 0);
+        ck_assert(!bigint_job_result(jobs[i], result));
+
+        bigint_job_delete(jobs[i]);
+        bigint_delete(expected[i]);
+    }
+
+    // Views are copied, the limbs can go away
+    uint32_t limbs[3] = { 1, 2, 3 };
+    bigint_t view;
+    bigint_wrap(&view, limbs, 3);
+
+    bigint_job_t* job = bigint_mul_async(&view, &view);
+    ck_assert(job != NULL);
+    ck_assert(bigint_mul(result, &view, &view));
+    bigint_release(&view);
+    memset(limbs, 0xFF, sizeof(limbs));
+
+    bigint_t* square = bigint_new();
+    ck_assert_int_eq(bigint_job_wait(job), BIGINT_JOB_DONE);
+    ck_assert(bigint_job_result(job, square));
+    ck_assert(bigint_cmp(square, result) == 0);
+    bigint_job_delete(job);
+
+    bigint_delete(square);
+    bigint_delete(result);
+}
+END_TEST
+
+START_TEST(test_bigint_async_poll_delete)
+{
+    bigint_t* a = random_number(8);
+
+    // Seen finished and deleted at once, while the worker may still be
+    // signalling
+    for (int i = 0; i < 500; i++) {
+        bigint_job_t* job = bigint_mul_async(a, a);
+        ck_assert(job != NULL);
+
+        while (bigint_job_poll(job) == BIGINT_JOB_RUNNING) {
+        }
+        bigint_job_delete(job);
+    }
+
+    bigint_delete(a);
+}
+END_TEST
+
+START_TEST(test_bigint_async_to_string)
+{
+    bigint_t* number = random_number(3000);
+    unsigned  bases[] = { 10, 16, 7, 36 };
+
+    for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); i++) {
+        bigint_job_t* job = bigint_to_string_async(number, bases[i]);
+        ck_assert(job != NULL);
+
+        char* expected = bigint_to_string(number, bases[i]);
+        ck_assert_int_eq(bigint_job_wait(job), BIGINT_JOB_DONE);
+
+        char* string = bigint_job_string(job);
+        ck_assert_str_eq(string, expected);
+        ck_assert(bigint_job_string(job) == NULL);
+        ck_assert(!bigint_job_result(job, number));
+
+        free(string);
+        free(expected);
+        bigint_job_delete(job);
+    }
+
+    // Bad bases fail like bigint_to_string does
+    bigint_job_t* job = bigint_to_string_async(number, 1);
+    ck_assert(job != NULL);
+    ck_assert_int_eq(bigint_job_wait(job), BIGINT_JOB_FAILED);
+    ck_assert(bigint_job_string(job) == NULL);
+    bigint_job_delete(job);
+
+    bigint_delete(number);
+}
+END_TEST
+
+START_TEST(test_bigint_async_cancel)
+{
+    // One worker, so the second job waits behind the first
+    bigint_async_shutdown();
+    bigint_async_set_threads(1);
+
+    bigint_t* a = random_number(200000);
+    bigint_t* b = random_number(200000);
+
+    bigint_job_t* slow   = bigint_mul_async(a, b);
+    bigint_job_t* queued = bigint_mul_async(a, a);
+    ck_assert(slow != NULL && queued != NULL);
+
+    // Gets somewhere, and only forward
+    double last = 0.0;
+    while (bigint_job_progress(slow) == 0.0) {
+    }
+    ck_assert_int_eq(bigint_job_poll(slow), BIGINT_JOB_RUNNING);
+    for (int i = 0; i < 1000; i++) {
+        double progress = bigint_job_progress(slow);
+        ck_assert(progress >= last && progress <= 1.0);
+        last = progress;
+    }
+
+    bigint_job_cancel(queued);
+    ck_assert_int_eq(bigint_job_poll(queued), BIGINT_JOB_CANCELLED);
+
+    bigint_job_cancel(slow);
+    ck_assert_int_eq(bigint_job_wait(slow), BIGINT_JOB_CANCELLED);
+    ck_assert(!bigint_job_result(slow, a));
+
+    bigint_job_delete(slow);
+    bigint_job_delete(queued);
+
+    // Deleted while running
+    bigint_job_delete(bigint_to_string_async(a, 10));
+
+    // The pool starts again after a shutdown
+    bigint_async_shutdown();
+    bigint_async_set_threads(0);
+
+    bigint_t*     c   = random_number(10);
+    bigint_job_t* job = bigint_mul_async(c, c);
+    ck_assert(job != NULL);
+    ck_assert_int_eq(bigint_job_wait(job), BIGINT_JOB_DONE);
+    bigint_job_delete(job);
+
+    bigint_async_shutdown();
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(c);
+}
+END_TEST
+
+Suite* bigint_async_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntAsync");
+
+    tc_core = tcase_create("Core");
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_test(tc_core, test_bigint_async_mul);
+    tcase_add_test(tc_core, test_bigint_async_poll_delete);
+    tcase_add_test(tc_core, test_bigint_async_to_string);
+    tcase_add_test(tc_core, test_bigint_async_cancel);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_async_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,306 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<string.h>
+#include<time.h>
+#include<bigint_ct.h>
+
+#include "random.h"
+
+Suite* bigint_ct_suite(void);
+
+static void random_limbs(uint32_t* a, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        a[i] = rand() % 4 == 0 ? 0xFFFFFFFFu : (uint32_t) rand() * 2654435761u;
+    }
+}
+
+// A random number of n limbs below m, most of the time.
+static void random_below(uint32_t* a, bigint_t* m, size_t n)
+{
+    bigint_t* x = random_number(n + 1);
+
+    bigint_divmod(NULL, x, x, m);
+    ck_assert(bigint_ct_import(a, n, x));
+    bigint_delete(x);
+}
+
+static bool limbs_equal(bigint_t* number, const uint32_t* a, size_t n)
+{
+    bigint_t view;
+    bigint_wrap(&view, a, n);
+
+    bool equal = bigint_cmp(number, &view) == 0;
+    bigint_release(&view);
+    return equal;
+}
+
+START_TEST(test_bigint_ct_compare)
+{
+    uint32_t a[20], b[20], r[20];
+
+    for (size_t n = 1; n <= 20; n++) {
+        for (int round = 0; round < 20; round++) {
+            random_limbs(a, n);
+            random_limbs(b, n);
+
+            // Equal, or differing in a single limb
+            if (round % 3 == 0) {
+                memcpy(b, a, sizeof(a));
+            }
+            if (round % 3 == 1) {
+                memcpy(b, a, sizeof(a));
+                b[(size_t) rand() % n] ^= 1u << (rand() % 32);
+            }
+
+            bigint_t x, y;
+            bigint_wrap(&x, a, n);
+            bigint_wrap(&y, b, n);
+
+            int expected = bigint_cmp(&x, &y);
+            ck_assert_int_eq(bigint_ct_cmp(a, b, n), expected);
+            ck_assert_uint_eq(bigint_ct_less(a, b, n), expected < 0 ? 0xFFFFFFFFu : 0);
+            ck_assert_uint_eq(bigint_ct_equals(a, b, n), expected == 0 ? 0xFFFFFFFFu : 0);
+            ck_assert_uint_eq(bigint_ct_is_zero(a, n), bigint_is_zero(&x) ? 0xFFFFFFFFu : 0);
+
+            bigint_release(&x);
+            bigint_release(&y);
+
+            bigint_ct_select(r, 0xFFFFFFFFu, a, b, n);
+            ck_assert_int_eq(memcmp(r, a, n * sizeof(uint32_t)), 0);
+            bigint_ct_select(r, 0, a, b, n);
+            ck_assert_int_eq(memcmp(r, b, n * sizeof(uint32_t)), 0);
+
+            memcpy(r, a, sizeof(a));
+            bigint_ct_swap(0, r, b, n);
+            ck_assert_int_eq(memcmp(r, a, n * sizeof(uint32_t)), 0);
+            bigint_ct_swap(0xFFFFFFFFu, r, b, n);
+            ck_assert_int_eq(memcmp(b, a, n * sizeof(uint32_t)), 0);
+        }
+    }
+
+    memset(a, 0, sizeof(a));
+    ck_assert_uint_eq(bigint_ct_is_zero(a, 20), 0xFFFFFFFFu);
+    ck_assert_uint_eq(bigint_ct_is_zero(a, 0), 0xFFFFFFFFu);
+}
+END_TEST
+
+START_TEST(test_bigint_ct_add_sub)
+{
+    uint32_t a[30], b[30], r[31];
+
+    for (size_t n = 1; n <= 30; n++) {
+        random_limbs(a, n);
+        random_limbs(b, n);
+
+        bigint_t x, y;
+        bigint_wrap(&x, a, n);
+        bigint_wrap(&y, b, n);
+
+        bigint_t* expected = bigint_new();
+
+        // The carry is the limb in front
+        r[0] = bigint_ct_add(r + 1, a, b, n);
+        ck_assert(bigint_add(expected, &x, &y));
+        ck_assert(limbs_equal(expected, r, n + 1));
+
+        // And the borrow says which way round it goes
+        uint32_t borrow = bigint_ct_sub(r, a, b, n);
+        ck_assert_uint_eq(borrow, bigint_cmp(&x, &y) < 0);
+        if (borrow) {
+            ck_assert(bigint_ct_add(r, r, b, n) == 1);
+            ck_assert(limbs_equal(&x, r, n));
+        } else {
+            ck_assert(bigint_sub(expected, &x, &y));
+            ck_assert(limbs_equal(expected, r, n));
+        }
+
+        bigint_release(&x);
+        bigint_release(&y);
+        bigint_delete(expected);
+    }
+}
+END_TEST
+
+START_TEST(test_bigint_ct_modular)
+{
+    uint32_t a[40], b[40], r[40];
+
+    for (size_t n = 1; n < 40; n += 2) {
+        bigint_t* m = random_number(n);
+        bigint_setbit(m, 32 * n - 1, 1);
+        bigint_setbit(m, 0, 1);
+
+        bigint_mont_t mont;
+        ck_assert(bigint_mont_init(&mont, m));
+
+        bigint_t* expected = bigint_new();
+
+        for (int round = 0; round < 10; round++) {
+            random_below(a, m, n);
+            random_below(b, m, n);
+
+            bigint_t x, y;
+            bigint_wrap(&x, a, n);
+            bigint_wrap(&y, b, n);
+
+            ck_assert(bigint_ct_addmod(&mont, r, a, b));
+            ck_assert(bigint_add(expected, &x, &y));
+            ck_assert(bigint_divmod(NULL, expected, expected, m));
+            ck_assert(limbs_equal(expected, r, n));
+
+            ck_assert(bigint_ct_submod(&mont, r, a, b));
+            ck_assert(bigint_add(expected, &x, m));
+            ck_assert(bigint_sub(expected, expected, &y));
+            ck_assert(bigint_divmod(NULL, expected, expected, m));
+            ck_assert(limbs_equal(expected, r, n));
+
+            ck_assert(bigint_mul(expected, &x, &y));
+            ck_assert(bigint_divmod(NULL, expected, expected, m));
+
+            bigint_release(&x);
+            bigint_release(&y);
+
+            // Into one of its operands
+            ck_assert(bigint_ct_mulmod(&mont, a, a, b));
+            ck_assert(limbs_equal(expected, a, n));
+        }
+
+        bigint_mont_free(&mont);
+        bigint_delete(m);
+        bigint_delete(expected);
+    }
+}
+END_TEST
+
+START_TEST(test_bigint_ct_powm)
+{
+    uint32_t a[24], e[4], r[24];
+
+    for (size_t n = 1; n < 24; n += 3) {
+        bigint_t* m = random_number(n);
+        bigint_setbit(m, 0, 1);
+
+        // Trimmed, so its top limb isn't zero
+        size_t mn;
+        bigint_limbs(m, &mn);
+
+        bigint_mont_t mont;
+        ck_assert(bigint_mont_init(&mont, m));
+
+        bigint_t* expected = bigint_new();
+
+        for (size_t en = 0; en <= 4; en++) {
+            random_below(a, m, mn);
+            random_limbs(e, en);
+
+            // A short exponent with leading zero limbs, and zero
+            if (en == 4) {
+                e[0] = e[1] = 0;
+            }
+            if (en == 2) {
+                e[0] = e[1] = 0;
+            }
+
+            bigint_t x, y;
+            bigint_wrap(&x, a, mn);
+            bigint_wrap(&y, e, en);
+
+            ck_assert(bigint_ct_powm(&mont, r, a, e, en));
+            ck_assert(bigint_powm(expected, &x, &y, m));
+            ck_assert(limbs_equal(expected, r, mn));
+
+            bigint_release(&x);
+            bigint_release(&y);
+        }
+
+        bigint_mont_free(&mont);
+        bigint_delete(m);
+        bigint_delete(expected);
+    }
+
+    // Modulo one everything is zero
+    bigint_t* one = bigint_new();
+    bigint_set_u32(one, 1);
+
+    bigint_mont_t mont;
+    ck_assert(bigint_mont_init(&mont, one));
+
+    a[0] = 0;
+    e[0] = 5;
+    r[0] = 7;
+    ck_assert(bigint_ct_powm(&mont, r, a, e, 1));
+    ck_assert_uint_eq(r[0], 0);
+
+    bigint_mont_free(&mont);
+    bigint_delete(one);
+}
+END_TEST
+
+START_TEST(test_bigint_ct_import_export)
+{
+    uint32_t  a[8];
+    bigint_t* x = random_number(5);
+    bigint_t* y = bigint_new();
+
+    ck_assert(bigint_ct_import(a, 8, x));
+    ck_assert(limbs_equal(x, a, 8));
+    ck_assert(bigint_ct_import(a, 5, x));
+    ck_assert(!bigint_ct_import(a, 4, x));
+
+    // Leading zero limbs fit
+    bigint_resize(x, 9);
+    ck_assert(bigint_ct_import(a, 5, x));
+    ck_assert(limbs_equal(x, a, 5));
+
+    // And are kept on the way out
+    a[0] = 0;
+    ck_assert(bigint_ct_export(y, a, 5));
+    ck_assert_uint_eq(y->size, 5);
+    ck_assert(limbs_equal(y, a, 5));
+
+    ck_assert(bigint_ct_export(y, a, 0));
+    ck_assert(bigint_is_zero(y));
+
+    bigint_delete(x);
+    bigint_delete(y);
+}
+END_TEST
+
+Suite* bigint_ct_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntCt");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_ct_compare);
+    tcase_add_test(tc_core, test_bigint_ct_add_sub);
+    tcase_add_test(tc_core, test_bigint_ct_modular);
+    tcase_add_test(tc_core, test_bigint_ct_powm);
+    tcase_add_test(tc_core, test_bigint_ct_import_export);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_ct_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
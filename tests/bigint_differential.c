@@ -0,0 +1,182 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<stdio.h>
+#include<time.h>
+#include<bigint_tune.h>
+
+#include "differential.h"
+
+Suite* bigint_differential_suite(void);
+
+#define DIFFERENTIAL_CASES 30
+
+static uint32_t random_limb(void)
+{
+    return (uint32_t) rand() * 2654435761u ^ (uint32_t) rand();
+}
+
+// Random limbs, all ones, a lone top bit, sparse limbs, a run of ones below
+// random limbs, and leading zero limbs that weren't trimmed away.
+static bigint_t* random_operand(size_t limbs)
+{
+    bigint_t* number = bigint_new();
+    int       shape  = rand() % 6;
+
+    bigint_resize(number, limbs);
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint32_t limb;
+
+        switch (shape) {
+            case 0:  limb = random_limb();                           break;
+            case 1:  limb = 0xFFFFFFFFu;                             break;
+            case 2:  limb = i == 0 ? 0x80000000u : 0;                break;
+            case 3:  limb = rand() % 3 == 0 ? random_limb() : 0;     break;
+            case 4:  limb = i < limbs / 2 ? 0xFFFFFFFFu : random_limb(); break;
+            default: limb = i < limbs / 2 ? 0 : random_limb();      break;
+        }
+
+        array_set(number, i, &limb);
+    }
+
+    return number;
+}
+
+// Sizes either side of every threshold and of their doubles, where the
+// recursions split, plus the smallest ones.
+static size_t random_size(size_t cap)
+{
+    size_t sizes[16 + 3 * BIGINT_THRESHOLDS];
+    size_t count = 0;
+
+    for (size_t n = 0; n < 16; n++) {
+        sizes[count++] = n;
+    }
+
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        size_t t = bigint_threshold_get((bigint_threshold_t) i);
+        sizes[count++] = t - 1;
+        sizes[count++] = t + 1;
+        sizes[count++] = 2 * t + 1 - (size_t) (rand() % 3);
+    }
+
+    size_t n = rand() % 4 == 0 ? (size_t) rand() % (cap + 1) : sizes[(size_t) rand() % count];
+    return n > cap ? (size_t) rand() % (cap + 1) : n;
+}
+
+static uint32_t random_small(differential_op_t op)
+{
+    switch (op) {
+        case DIFFERENTIAL_MUL_U32:
+        case DIFFERENTIAL_DIVMOD_U32: {
+            uint32_t values[4] = { 0, 1, 0xFFFFFFFFu, random_limb() };
+            return values[rand() % 4];
+        }
+        case DIFFERENTIAL_SHL:
+        case DIFFERENTIAL_SHR:       return (uint32_t) (rand() % 200);
+        case DIFFERENTIAL_TO_STRING: return (uint32_t) (rand() % 38);
+        case DIFFERENTIAL_ROOT:      return (uint32_t) (rand() % 8);
+        default:                     return 0;
+    }
+}
+
+static void differential_run_all(void)
+{
+    for (int op = 0; op < DIFFERENTIAL_OPS; op++) {
+        for (int i = 0; i < DIFFERENTIAL_CASES; i++) {
+            // The reference is slow at GCDs and modular powers.
+            bool   slow = op == DIFFERENTIAL_GCD || op == DIFFERENTIAL_GCDEXT || op == DIFFERENTIAL_INVERT;
+            size_t cap  = op == DIFFERENTIAL_POWM ? 12 : slow ? 24 : 140;
+
+            differential_case_t test = {
+                .op    = (differential_op_t) op,
+                .alias = (differential_alias_t) (rand() % DIFFERENTIAL_ALIASES),
+                .a     = random_operand(random_size(cap)),
+                .b     = random_operand(op == DIFFERENTIAL_POWM ? (size_t) rand() % 3 : random_size(cap)),
+                .c     = random_operand(random_size(cap)),
+                .small = random_small((differential_op_t) op),
+            };
+
+            ck_assert_msg(differential_check(&test), "%s mismatch", differential_op_name(test.op));
+
+            bigint_delete(test.a);
+            bigint_delete(test.b);
+            bigint_delete(test.c);
+        }
+    }
+}
+
+static void differential_run_with(size_t threshold)
+{
+    size_t saved[BIGINT_THRESHOLDS];
+
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        saved[i] = bigint_threshold_get((bigint_threshold_t) i);
+        bigint_threshold_set((bigint_threshold_t) i, threshold);
+    }
+
+    differential_run_all();
+
+    for (int i = 0; i < BIGINT_THRESHOLDS; i++) {
+        bigint_threshold_set((bigint_threshold_t) i, saved[i]);
+    }
+}
+
+START_TEST(test_differential_default_thresholds)
+{
+    differential_run_all();
+}
+END_TEST
+
+START_TEST(test_differential_smallest_thresholds)
+{
+    // Clamped to the smallest each one accepts, so every split is exercised
+    differential_run_with(0);
+}
+END_TEST
+
+START_TEST(test_differential_basecase_only)
+{
+    differential_run_with(1000);
+}
+END_TEST
+
+Suite* bigint_differential_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntDifferential");
+
+    tc_core = tcase_create("Core");
+    tcase_set_timeout(tc_core, 120);
+    tcase_add_test(tc_core, test_differential_default_thresholds);
+    tcase_add_test(tc_core, test_differential_smallest_thresholds);
+    tcase_add_test(tc_core, test_differential_basecase_only);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    // Pass a seed to replay a failure
+    unsigned int seed = argc > 1 ? (unsigned int) strtoul(argv[1], NULL, 10) : (unsigned int) time(NULL);
+    printf("seed %u\n", seed);
+    srand(seed);
+
+    Suite*   s  = bigint_differential_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
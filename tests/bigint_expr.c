@@ -0,0 +1,230 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_expr.h>
+#include<bigint_tune.h>
+#include<stdio.h>
+
+#include "random.h"
+
+START_TEST(test_bigint_expr_leaf_root)
+{
+    bigint_t* a        = bigint_new();
+    bigint_t* expected = bigint_new();
+
+    // Three limbs with a leading zero, evaluated into itself
+    uint32_t limbs[3] = { 0, 0x12345678, 0x9ABCDEF0 };
+    bigint_resize(a, 3);
+    for (size_t i = 0; i < 3; i++) {
+        array_set(a, i, &limbs[i]);
+    }
+    ck_assert(bigint_set_u64(expected, 0x123456789ABCDEF0ull));
+
+    bigint_expr_t e;
+    bigint_expr_init(&e);
+
+    bigint_expr_node_t n = bigint_expr_leaf(&e, a);
+    ck_assert(bigint_expr_eval(&e, a, n));
+    ck_assert_uint_eq(a->size, 2);
+    ck_assert(bigint_equals(a, expected));
+
+    // And into another number
+    bigint_t* r = bigint_new();
+    ck_assert(bigint_expr_eval(&e, r, n));
+    ck_assert(bigint_equals(r, expected));
+
+    bigint_expr_free(&e);
+    bigint_delete(a);
+    bigint_delete(r);
+    bigint_delete(expected);
+}
+END_TEST
+
+Suite* bigint_expr_suite(void);
+
+START_TEST(test_bigint_expr_fused)
+{
+    size_t sizes[6] = { 1, 2, 7, 40, 90, 200 };
+
+    bigint_expr_t e;
+    bigint_expr_init(&e);
+
+    for (size_t i = 0; i < 6; i++) {
+        bigint_t* a = random_number(sizes[i]);
+        bigint_t* b = random_number(sizes[(i + 1) % 6]);
+        bigint_t* c = random_number(sizes[(i + 2) % 6]);
+        bigint_t* d = random_number(1);
+        bigint_t* x = random_number(sizes[i] / 2 + 1);
+
+        // a b + c d - x, the slow way
+        bigint_t* expected = bigint_new();
+        bigint_t* t        = bigint_new();
+        bigint_mul(expected, a, b);
+        bigint_mul(t, c, d);
+        bigint_add(expected, expected, t);
+
+        bool positive = bigint_cmp(expected, x) >= 0;
+        if (positive) {
+            bigint_sub(expected, expected, x);
+        }
+
+        bigint_expr_clear(&e);
+        bigint_expr_node_t ab = bigint_expr_mul(&e, bigint_expr_leaf(&e, a), bigint_expr_leaf(&e, b));
+        bigint_expr_node_t cd = bigint_expr_mul(&e, bigint_expr_leaf(&e, c), bigint_expr_leaf(&e, d));
+        bigint_expr_node_t r  = bigint_expr_sub(&e, bigint_expr_add(&e, ab, cd), bigint_expr_leaf(&e, x));
+
+        bigint_t* result = bigint_new();
+        ck_assert(bigint_expr_eval(&e, result, r) == positive);
+        if (positive) {
+            ck_assert(bigint_equals(result, expected));
+        }
+
+        // Into one of its own leaves
+        if (positive) {
+            ck_assert(bigint_expr_eval(&e, a, r));
+            ck_assert(bigint_equals(a, expected));
+        }
+
+        bigint_delete(a);
+        bigint_delete(b);
+        bigint_delete(c);
+        bigint_delete(d);
+        bigint_delete(x);
+        bigint_delete(t);
+        bigint_delete(expected);
+        bigint_delete(result);
+    }
+
+    bigint_expr_free(&e);
+}
+END_TEST
+
+START_TEST(test_bigint_expr_negative_terms)
+{
+    bigint_t* a = random_number(30);
+    bigint_t* b = random_number(20);
+    bigint_t* r = bigint_new();
+
+    bigint_setbit(a, 30 * 32 - 1, 1);
+
+    bigint_expr_t e;
+    bigint_expr_init(&e);
+
+    // (b - a)(b - a) and (b - a) - (b - a) - 1, the inner ones go negative
+    bigint_expr_node_t na = bigint_expr_leaf(&e, a);
+    bigint_expr_node_t nb = bigint_expr_leaf(&e, b);
+    bigint_expr_node_t d  = bigint_expr_sub(&e, nb, na);
+    bigint_expr_node_t sq = bigint_expr_mul(&e, d, d);
+    bigint_expr_node_t z  = bigint_expr_sub(&e, d, bigint_expr_sub(&e, nb, na));
+    bigint_expr_node_t m  = bigint_expr_sub(&e, z, bigint_expr_u32(&e, 1));
+
+    bigint_t* expected = bigint_new();
+    bigint_sub(expected, a, b);
+    bigint_mul(expected, expected, expected);
+
+    ck_assert(bigint_expr_eval(&e, r, sq));
+    ck_assert(bigint_equals(r, expected));
+
+    ck_assert(bigint_expr_eval(&e, r, z));
+    ck_assert(bigint_is_zero(r));
+
+    ck_assert(!bigint_expr_eval(&e, r, m));
+    ck_assert(!bigint_expr_eval(&e, r, BIGINT_EXPR_NONE));
+    ck_assert_uint_eq(bigint_expr_add(&e, na, BIGINT_EXPR_NONE), BIGINT_EXPR_NONE);
+    ck_assert_uint_eq(bigint_expr_mul(&e, 1000, na), BIGINT_EXPR_NONE);
+
+    bigint_expr_free(&e);
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(r);
+    bigint_delete(expected);
+}
+END_TEST
+
+START_TEST(test_bigint_expr_horner)
+{
+    // p(x) = sum of c[i] x^i by Horner's rule, reevaluated as x changes
+    bigint_t* c[8];
+    bigint_t* x = bigint_new();
+    bigint_t* r = bigint_new();
+    size_t    saved = bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    for (int i = 0; i < 8; i++) {
+        c[i] = random_number((size_t) (rand() % 12));
+    }
+
+    bigint_expr_t e;
+    bigint_expr_init(&e);
+
+    bigint_expr_node_t nx = bigint_expr_leaf(&e, x);
+    bigint_expr_node_t p  = bigint_expr_leaf(&e, c[7]);
+    for (int i = 6; i >= 0; i--) {
+        p = bigint_expr_add(&e, bigint_expr_mul(&e, p, nx), bigint_expr_leaf(&e, c[i]));
+    }
+
+    for (int round = 0; round < 6; round++) {
+        bigint_t* value = random_number((size_t) (round * 5));
+        bigint_copy(x, value);
+        bigint_delete(value);
+
+        bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, round % 2 ? 0 : saved);
+
+        bigint_t* expected = bigint_new();
+        bigint_copy(expected, c[7]);
+        for (int i = 6; i >= 0; i--) {
+            bigint_mul(expected, expected, x);
+            bigint_add(expected, expected, c[i]);
+        }
+
+        ck_assert(bigint_expr_eval(&e, r, p));
+        ck_assert(bigint_equals(r, expected));
+        bigint_delete(expected);
+    }
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, saved);
+    bigint_expr_free(&e);
+
+    for (int i = 0; i < 8; i++) {
+        bigint_delete(c[i]);
+    }
+    bigint_delete(x);
+    bigint_delete(r);
+}
+END_TEST
+
+Suite* bigint_expr_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntExpr");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_expr_fused);
+    tcase_add_test(tc_core, test_bigint_expr_negative_terms);
+    tcase_add_test(tc_core, test_bigint_expr_horner);
+    tcase_add_test(tc_core, test_bigint_expr_leaf_root);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_expr_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
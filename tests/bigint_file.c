@@ -0,0 +1,166 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_file.h>
+#include<stddef.h>
+#include<stdio.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+#include "random.h"
+
+Suite* bigint_file_suite(void);
+
+START_TEST(test_bigint_file_save_and_map)
+{
+    char path[] = "/tmp/bigint_file_XXXXXX";
+    int  fd     = mkstemp(path);
+    ck_assert(fd >= 0);
+    close(fd);
+
+    bigint_t* number = random_number(1000);
+    ck_assert(bigint_file_save(path, number));
+
+    bigint_map_t map;
+    ck_assert(bigint_file_map(&map, path, true));
+    ck_assert(bigint_equals(number, &map.number));
+
+    // The limbs should live right after the header, inside the mapping
+    ck_assert(map.number.items == (uint8_t*) map.base + sizeof(bigint_file_header_t));
+
+    // Writing to the mapped number copies first
+    bigint_setbit(&map.number, 0, 1);
+    ck_assert(map.number.items != (uint8_t*) map.base + sizeof(bigint_file_header_t));
+    bigint_file_unmap(&map);
+
+    bigint_t* loaded = bigint_new();
+    ck_assert(bigint_file_load(loaded, path));
+    ck_assert(bigint_equals(number, loaded));
+
+    bigint_delete(number);
+    bigint_delete(loaded);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(test_bigint_file_streaming_writer)
+{
+    char path[] = "/tmp/bigint_file_XXXXXX";
+    int  fd     = mkstemp(path);
+    ck_assert(fd >= 0);
+
+    bigint_t* number = random_number(300);
+
+    // Same number, written in three chunks
+    bigint_writer_t writer;
+    ck_assert(bigint_writer_open(&writer, fd));
+    ck_assert(bigint_writer_append(&writer, (uint32_t*) number->items, 100));
+    ck_assert(bigint_writer_append(&writer, (uint32_t*) number->items + 100, 150));
+    ck_assert(bigint_writer_append(&writer, (uint32_t*) number->items + 250, 50));
+    ck_assert(bigint_writer_close(&writer));
+    close(fd);
+
+    bigint_map_t map;
+    ck_assert(bigint_file_map(&map, path, true));
+    ck_assert(map.number.size == 300);
+    ck_assert(bigint_equals(number, &map.number));
+    bigint_file_unmap(&map);
+
+    bigint_delete(number);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(test_bigint_file_corruption)
+{
+    char path[] = "/tmp/bigint_file_XXXXXX";
+    int  fd     = mkstemp(path);
+    ck_assert(fd >= 0);
+    close(fd);
+
+    bigint_t* number = random_number(10);
+    ck_assert(bigint_file_save(path, number));
+
+    // Flip one bit of the last limb
+    FILE* f = fopen(path, "r+b");
+    ck_assert(f != NULL);
+    fseek(f, -1, SEEK_END);
+    int c = fgetc(f);
+    fseek(f, -1, SEEK_END);
+    fputc(c ^ 1, f);
+    fclose(f);
+
+    bigint_map_t map;
+    ck_assert(!bigint_file_map(&map, path, true));  // Checksum mismatch
+    ck_assert( bigint_file_map(&map, path, false)); // Unless we don't look
+    bigint_file_unmap(&map);
+
+    // The number is left alone
+    bigint_t* loaded = bigint_new();
+    bigint_set_u32(loaded, 42);
+    ck_assert(!bigint_file_load(loaded, path));
+    ck_assert(bigint_get_u64(loaded) == 42);
+
+    // Counts that don't match the length, or would wrap when sized in bytes
+    uint64_t counts[] = { 11, 9, 0xFFFFFFFFFFFFFFFFull, 0x4000000000000003ull };
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        ck_assert(bigint_file_save(path, number));
+
+        fd = open(path, O_WRONLY);
+        ck_assert(fd >= 0);
+        ck_assert(pwrite(fd, &counts[i], sizeof(uint64_t), offsetof(bigint_file_header_t, count)) == sizeof(uint64_t));
+        close(fd);
+
+        ck_assert(!bigint_file_load(loaded, path));
+        ck_assert(bigint_get_u64(loaded) == 42);
+    }
+
+    // Not a bigint file at all
+    f = fopen(path, "wb");
+    fputs("1234567890", f);
+    fclose(f);
+    ck_assert(!bigint_file_map(&map, path, false));
+    ck_assert(!bigint_file_load(loaded, path));
+
+    bigint_delete(number);
+    bigint_delete(loaded);
+    unlink(path);
+}
+END_TEST
+
+Suite* bigint_file_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntFile");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_file_save_and_map);
+    tcase_add_test(tc_core, test_bigint_file_streaming_writer);
+    tcase_add_test(tc_core, test_bigint_file_corruption);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_file_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,226 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_gcd.h>
+#include<bigint_tune.h>
+#include<stdio.h>
+
+#include "random.h"
+
+Suite* bigint_gcd_suite(void);
+
+START_TEST(test_bigint_gcd_small)
+{
+    bigint_t* a = bigint_new();
+    bigint_t* b = bigint_new();
+    bigint_t* g = bigint_new();
+
+    ck_assert(bigint_set_u32(a, 0) && bigint_set_u32(b, 0));
+    ck_assert(bigint_gcd(g, a, b));
+    ck_assert(bigint_is_zero(g));
+    ck_assert(bigint_set_u32(g, 5));
+    ck_assert(bigint_gcdext(g, a, a, b));
+    ck_assert(bigint_is_zero(g) && bigint_is_zero(a));
+
+    ck_assert(bigint_set_u32(a, 12));
+    ck_assert(bigint_gcd(g, a, b));
+    ck_assert(bigint_get_u64(g) == 12);
+    ck_assert(bigint_gcd(g, b, a));
+    ck_assert(bigint_get_u64(g) == 12);
+
+    ck_assert(bigint_set_u64(a, 2ull * 3 * 5 * 7 * 11 * 13 * 1000003ull));
+    ck_assert(bigint_set_u64(b, 3ull * 7 * 13 * 17 * 1000003ull));
+    ck_assert(bigint_gcd(g, a, b));
+    ck_assert(bigint_get_u64(g) == 3ull * 7 * 13 * 1000003ull);
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(g);
+}
+END_TEST
+
+START_TEST(test_bigint_gcd_large)
+{
+    bigint_t* g = bigint_new();
+    bigint_t* s = bigint_new();
+    bigint_t* t = bigint_new();
+
+    for (size_t limbs = 2; limbs < 120; limbs += 9) {
+        bigint_t* a = random_number(limbs);
+        bigint_t* b = random_number(limbs / 2 + 3);
+        bigint_t* c = random_number(limbs % 7 + 1);
+
+        // gcd(a * c, b * c) is gcd(a, b) * c
+        ck_assert(bigint_gcd(g, a, b));
+        ck_assert(bigint_mul(g, g, c));
+        ck_assert(bigint_mul(a, a, c));
+        ck_assert(bigint_mul(b, b, c));
+        ck_assert(bigint_gcd(t, a, b));
+        ck_assert(bigint_cmp(t, g) == 0);
+
+        // Both divide evenly
+        ck_assert(bigint_divmod(NULL, t, a, g) && bigint_is_zero(t));
+        ck_assert(bigint_divmod(NULL, t, b, g) && bigint_is_zero(t));
+
+        // Same gcd from gcdext, and a * s = g (mod b) with s < b / g
+        ck_assert(bigint_gcdext(t, s, a, b));
+        ck_assert(bigint_cmp(t, g) == 0);
+        ck_assert(bigint_mul(t, a, s));
+        ck_assert(bigint_divmod(NULL, t, t, b));
+        ck_assert(bigint_cmp(t, g) == 0 || (bigint_cmp(b, g) == 0 && bigint_is_zero(t)));
+        ck_assert(bigint_divmod(t, NULL, b, g));
+        ck_assert(bigint_cmp(s, t) < 0);
+
+        bigint_delete(a);
+        bigint_delete(b);
+        bigint_delete(c);
+    }
+
+    bigint_delete(g);
+    bigint_delete(s);
+    bigint_delete(t);
+}
+END_TEST
+
+START_TEST(test_bigint_invert)
+{
+    bigint_t* m = bigint_new();
+    bigint_t* r = bigint_new();
+    bigint_t* t = bigint_new();
+
+    // 2^127 - 1 is prime, so everything below it has an inverse
+    bigint_setbit(m, 127, 1);
+    ck_assert(bigint_sub_u32(m, m, 1));
+
+    for (size_t limbs = 1; limbs <= 4; limbs++) {
+        bigint_t* a = random_number(limbs);
+        ck_assert(bigint_divmod(NULL, a, a, m));
+
+        ck_assert(bigint_invert(r, a, m));
+        ck_assert(bigint_mul(t, a, r));
+        ck_assert(bigint_divmod(NULL, t, t, m));
+        ck_assert(bigint_get_u64(t) == 1 && bigint_bitlen(t) == 1);
+
+        bigint_delete(a);
+    }
+
+    // No inverse when they share a factor
+    ck_assert(bigint_set_u32(m, 100));
+    ck_assert(bigint_set_u32(t, 15));
+    ck_assert(!bigint_invert(r, t, m));
+    ck_assert(bigint_set_u32(t, 0));
+    ck_assert(!bigint_invert(r, m, t));
+
+    bigint_delete(m);
+    bigint_delete(r);
+    bigint_delete(t);
+}
+END_TEST
+
+START_TEST(test_bigint_gcd_half)
+{
+    size_t    saved = bigint_threshold_get(BIGINT_THRESHOLD_GCD_HALF);
+    bigint_t* a     = bigint_new();
+    bigint_t* b     = bigint_new();
+    bigint_t* g[2]  = { bigint_new(), bigint_new() };
+    bigint_t* s[2]  = { bigint_new(), bigint_new() };
+    bigint_t* h[2]  = { bigint_new(), bigint_new() };
+
+    for (int i = 0; i < 12; i++) {
+        size_t limbs = 40 + (size_t) rand() % 700;
+
+        if (i < 8) {
+            // Random, sharing a factor now and then
+            bigint_t* x = random_number(limbs);
+            bigint_t* y = random_number(limbs - (size_t) rand() % (limbs / 2));
+            bigint_t* c = random_number(1 + (size_t) rand() % 40);
+
+            ck_assert(bigint_mul(a, x, i % 2 == 0 ? c : y));
+            ck_assert(bigint_mul(b, y, c));
+
+            bigint_delete(x);
+            bigint_delete(y);
+            bigint_delete(c);
+        } else if (i < 10) {
+            // Consecutive Fibonacci numbers, every quotient is 1
+            ck_assert(bigint_set_u32(a, 1) && bigint_set_u32(b, 1));
+            for (size_t j = 0; j < limbs * 46; j++) {
+                ck_assert(bigint_add(a, a, b));
+                bigint_swap(a, b);
+            }
+        } else {
+            // One huge quotient in the middle of the sequence
+            bigint_t* x = random_number(limbs / 2);
+            bigint_t* y = random_number(limbs / 4 + 1);
+
+            ck_assert(bigint_shl(a, x, limbs * 16));
+            ck_assert(bigint_add(a, a, y));
+            ck_assert(bigint_copy(b, x));
+
+            bigint_delete(x);
+            bigint_delete(y);
+        }
+
+        // Lehmer all the way against half-GCD steps all the way down
+        for (int half = 0; half < 2; half++) {
+            bigint_threshold_set(BIGINT_THRESHOLD_GCD_HALF, half ? 0 : SIZE_MAX);
+            ck_assert(bigint_gcd(g[half], a, b));
+            ck_assert(bigint_gcdext(h[half], s[half], a, b));
+        }
+
+        ck_assert(bigint_cmp(g[0], g[1]) == 0);
+        ck_assert(bigint_cmp(h[1], g[1]) == 0);
+        ck_assert(bigint_cmp(s[0], s[1]) == 0);
+
+        ck_assert(bigint_divmod(NULL, h[0], a, g[1]) && bigint_is_zero(h[0]));
+        ck_assert(bigint_divmod(NULL, h[0], b, g[1]) && bigint_is_zero(h[0]));
+    }
+
+    bigint_threshold_set(BIGINT_THRESHOLD_GCD_HALF, saved);
+
+    bigint_delete(a);
+    bigint_delete(b);
+    for (int i = 0; i < 2; i++) {
+        bigint_delete(g[i]);
+        bigint_delete(s[i]);
+        bigint_delete(h[i]);
+    }
+}
+END_TEST
+
+Suite* bigint_gcd_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntGCD");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_gcd_small);
+    tcase_add_test(tc_core, test_bigint_gcd_large);
+    tcase_add_test(tc_core, test_bigint_gcd_half);
+    tcase_add_test(tc_core, test_bigint_invert);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_gcd_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_io.h>
+#include<stdio.h>
+#include<string.h>
+#include<unistd.h>
+
+Suite* bigint_io_suite(void);
+
+static const char* two_to_2048 =
+    "3231700607131100730071487668866995196044410266971548403213034542"
+    "7524655138867890893197201411522913463688717960921898019494119559"
+    "1504909210950881523864482831206308773673009960917501977503896521"
+    "0679605763838406756827679221864261975616183809433847617047058164"
+    "5852036305042887575891541065808607552399123930385521914333389668"
+    "3424206849747865645694948561760353263220580778056593310261927084"
+    "6031415025859286417711672594360371846185735759835115230164590440"
+    "3697613233287231227125684710820209725157101726931323469678542580"
+    "6566979350459972683529986382155251663894373355436021354332296046"
+    "45318478604952148193555853611059596230656";
+
+START_TEST(test_bigint_to_string)
+{
+    bigint_t* number = bigint_new();
+    char*     str;
+
+    str = bigint_to_string(number, 10);
+    ck_assert_str_eq(str, "0");
+    free(str);
+
+    bigint_set_u64(number, 0xDEADBEEFCAFEull);
+    str = bigint_to_string(number, 16);
+    ck_assert_str_eq(str, "DEADBEEFCAFE");
+    free(str);
+    str = bigint_to_string(number, 10);
+    ck_assert_str_eq(str, "244837814094590");
+    free(str);
+    str = bigint_to_string(number, 36);
+    ck_assert_str_eq(str, "2ESCXSZJ0E");
+    free(str);
+
+    // 30!
+    bigint_set_u32(number, 1);
+    for (uint32_t i = 2; i <= 30; i++) {
+        bigint_mul_u32(number, number, i);
+    }
+    str = bigint_to_string(number, 10);
+    ck_assert_str_eq(str, "265252859812191058636308480000000");
+    free(str);
+
+    // Power of two bases, longer than the digit buffer
+    char expected[202];
+
+    bigint_set_u32(number, 1);
+    bigint_shl(number, number, 200);
+    bigint_sub_u32(number, number, 1);
+    memset(expected, '1', 200);
+    expected[200] = '\0';
+    str = bigint_to_string(number, 2);
+    ck_assert_str_eq(str, expected);
+    free(str);
+
+    bigint_add_u32(number, number, 1);
+    bigint_shl(number, number, 1);
+    expected[0] = '1';
+    memset(expected + 1, '0', 67);
+    expected[68] = '\0';
+    str = bigint_to_string(number, 8);
+    ck_assert_str_eq(str, expected);
+    free(str);
+
+    ck_assert(bigint_to_string(number, 1)  == NULL);
+    ck_assert(bigint_to_string(number, 37) == NULL);
+
+    bigint_delete(number);
+}
+END_TEST
+
+START_TEST(test_bigint_to_string_divide_and_conquer)
+{
+    bigint_t* number = bigint_new();
+    char*     str;
+
+    // 64 limbs, well past the base case
+    bigint_setbit(number, 2048, 1);
+    str = bigint_to_string(number, 10);
+    ck_assert_str_eq(str, two_to_2048);
+    free(str);
+
+    str = bigint_to_string(number, 2);
+    ck_assert(strlen(str) == 2049);
+    ck_assert(str[0] == '1');
+    ck_assert(strspn(str + 1, "0") == 2048);
+    free(str);
+
+    // Long runs of zeroes across the split points have to be padded back
+    bigint_set_u32(number, 7);
+    for (int i = 0; i < 1500; i++) {
+        bigint_mul_u32(number, number, 10);
+    }
+    str = bigint_to_string(number, 10);
+    ck_assert(strlen(str) == 1501);
+    ck_assert(str[0] == '7');
+    ck_assert(strspn(str + 1, "0") == 1500);
+    free(str);
+
+    bigint_delete(number);
+}
+END_TEST
+
+START_TEST(test_bigint_write)
+{
+    bigint_t* number = bigint_new();
+    bigint_setbit(number, 2048, 1);
+
+    FILE* stream = tmpfile();
+    ck_assert(stream != NULL);
+    ck_assert(bigint_write(stream, number, 10));
+    fflush(stream);
+    ck_assert(bigint_write_fd(fileno(stream), number, 10));
+
+    char   buffer[2048];
+    rewind(stream);
+    size_t got = fread(buffer, 1, sizeof(buffer) - 1, stream);
+    buffer[got] = '\0';
+    ck_assert(got == 2 * strlen(two_to_2048));
+    ck_assert(strncmp(buffer, two_to_2048, strlen(two_to_2048)) == 0);
+    ck_assert(strcmp(buffer + strlen(two_to_2048), two_to_2048) == 0);
+    fclose(stream);
+
+    bigint_delete(number);
+}
+END_TEST
+
+Suite* bigint_io_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntIO");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_to_string);
+    tcase_add_test(tc_core, test_bigint_to_string_divide_and_conquer);
+    tcase_add_test(tc_core, test_bigint_write);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_io_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_mont.h>
+#include<stdio.h>
+
+#include "random.h"
+
+Suite* bigint_mont_suite(void);
+
+// base^exponent mod modulus, the slow way.
+static bigint_t* naive_powm(bigint_t* base, uint32_t exponent, bigint_t* modulus)
+{
+    bigint_t* result = bigint_new();
+    bigint_set_u32(result, 1);
+    bigint_divmod(NULL, result, result, modulus);
+
+    for (uint32_t i = 0; i < exponent; i++) {
+        bigint_mul(result, result, base);
+        bigint_divmod(NULL, result, result, modulus);
+    }
+
+    return result;
+}
+
+START_TEST(test_bigint_mont_roundtrip)
+{
+    for (size_t limbs = 1; limbs < 40; limbs += 3) {
+        bigint_t* m = random_number(limbs);
+        bigint_setbit(m, 0, 1);
+
+        bigint_t* a = random_number(limbs + 2);
+        bigint_t* b = random_number(limbs);
+        bigint_t* x = bigint_new();
+        bigint_t* y = bigint_new();
+        bigint_t* p = bigint_new();
+
+        bigint_mont_t mont;
+        ck_assert(bigint_mont_init(&mont, m));
+
+        // to and from give back a mod m
+        ck_assert(bigint_mont_to(&mont, x, a));
+        ck_assert(bigint_cmp(x, m) < 0);
+        ck_assert(bigint_mont_from(&mont, y, x));
+        ck_assert(bigint_divmod(NULL, p, a, m));
+        ck_assert(bigint_cmp(y, p) == 0);
+
+        // Products match in Montgomery form
+        ck_assert(bigint_mont_to(&mont, y, b));
+        ck_assert(bigint_mont_mul(&mont, x, x, y));
+        ck_assert(bigint_mont_from(&mont, x, x));
+        ck_assert(bigint_mul(p, a, b));
+        ck_assert(bigint_divmod(NULL, p, p, m));
+        ck_assert(bigint_cmp(x, p) == 0);
+
+        bigint_mont_free(&mont);
+
+        bigint_delete(m);
+        bigint_delete(a);
+        bigint_delete(b);
+        bigint_delete(x);
+        bigint_delete(y);
+        bigint_delete(p);
+    }
+
+    // Even moduli are for bigint_powm only
+    bigint_t* m = bigint_new();
+    bigint_mont_t mont;
+    ck_assert(bigint_set_u32(m, 1000));
+    ck_assert(!bigint_mont_init(&mont, m));
+    ck_assert(bigint_set_u32(m, 0));
+    ck_assert(!bigint_mont_init(&mont, m));
+    bigint_delete(m);
+}
+END_TEST
+
+START_TEST(test_bigint_powm)
+{
+    bigint_t* e = bigint_new();
+    bigint_t* r = bigint_new();
+
+    for (size_t limbs = 1; limbs < 12; limbs++) {
+        bigint_t* m = random_number(limbs);
+        bigint_t* a = random_number(limbs + 1);
+
+        // Odd and even moduli, exponents across the window sizes
+        for (int parity = 0; parity < 2; parity++) {
+            bigint_setbit(m, 0, (uint32_t) parity);
+
+            uint32_t exponents[5] = { 0, 1, 2, 77, 300 };
+            for (size_t i = 0; i < 5; i++) {
+                bigint_t* expected = naive_powm(a, exponents[i], m);
+
+                ck_assert(bigint_set_u32(e, exponents[i]));
+                ck_assert(bigint_powm(r, a, e, m));
+                ck_assert(bigint_cmp(r, expected) == 0);
+
+                bigint_delete(expected);
+            }
+        }
+
+        bigint_delete(m);
+        bigint_delete(a);
+    }
+
+    // Fermat: a^(p - 1) = 1 mod p for the prime 2^521 - 1
+    bigint_t* p = bigint_new();
+    bigint_t* a = random_number(8);
+
+    ck_assert(bigint_set_u32(p, 1));
+    ck_assert(bigint_shl(p, p, 521));
+    ck_assert(bigint_sub_u32(p, p, 1));
+    ck_assert(bigint_sub_u32(e, p, 1));
+    ck_assert(bigint_powm(r, a, e, p));
+    ck_assert(bigint_get_u64(r) == 1 && bigint_bitlen(r) == 1);
+
+    // Anything modulo 1 is 0, and there is no modulo 0
+    ck_assert(bigint_set_u32(p, 1));
+    ck_assert(bigint_powm(r, a, e, p));
+    ck_assert(bigint_is_zero(r));
+    ck_assert(bigint_set_u32(p, 0));
+    ck_assert(!bigint_powm(r, a, e, p));
+
+    bigint_delete(p);
+    bigint_delete(a);
+    bigint_delete(e);
+    bigint_delete(r);
+}
+END_TEST
+
+Suite* bigint_mont_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntMont");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_mont_roundtrip);
+    tcase_add_test(tc_core, test_bigint_powm);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_mont_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
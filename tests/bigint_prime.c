@@ -0,0 +1,168 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<string.h>
+#include<bigint_prime.h>
+#include<stdio.h>
+
+Suite* bigint_prime_suite(void);
+
+// 2^bits + offset, offset may be negative
+static bigint_t* power_of_two(size_t bits, int offset)
+{
+    bigint_t* number = bigint_new();
+    bigint_set_u32(number, 1);
+    bigint_shl(number, number, bits);
+
+    if (offset < 0) {
+        bigint_sub_u32(number, number, (uint32_t) -offset);
+    } else {
+        bigint_add_u32(number, number, (uint32_t) offset);
+    }
+
+    return number;
+}
+
+#define SIEVE_LIMIT 100000
+
+START_TEST(test_bigint_is_probab_prime_small)
+{
+    static bool composite[SIEVE_LIMIT];
+    memset(composite, 0, sizeof(composite));
+    composite[0] = composite[1] = true;
+
+    for (size_t i = 2; i * i < SIEVE_LIMIT; i++) {
+        for (size_t j = i * i; !composite[i] && j < SIEVE_LIMIT; j += i) {
+            composite[j] = true;
+        }
+    }
+
+    bigint_t* n = bigint_new();
+    for (uint32_t i = 0; i < SIEVE_LIMIT; i++) {
+        ck_assert(bigint_set_u32(n, i));
+        ck_assert(bigint_is_probab_prime(n, 0) == !composite[i]);
+    }
+
+    // Just above the trial division range, 2047 squared, and pseudoprimes
+    // to several bases.
+    uint64_t primes[4]     = { 4194319, 4294967291u, 18446744073709551557ull, 1000000007 };
+    uint64_t composites[6] = { 4194304, 4190209, 3215031751u, 2152302898747ull, 3825123056546413051ull, 4194319ull * 4294967291u };
+
+    for (size_t i = 0; i < 4; i++) {
+        ck_assert(bigint_set_u64(n, primes[i]));
+        ck_assert(bigint_is_probab_prime(n, 2));
+    }
+    for (size_t i = 0; i < 6; i++) {
+        ck_assert(bigint_set_u64(n, composites[i]));
+        ck_assert(!bigint_is_probab_prime(n, 2));
+    }
+
+    bigint_delete(n);
+}
+END_TEST
+
+START_TEST(test_bigint_is_probab_prime_large)
+{
+    // Mersenne primes and their neighbours
+    size_t exponents[4] = { 89, 127, 521, 607 };
+
+    for (size_t i = 0; i < 4; i++) {
+        bigint_t* p = power_of_two(exponents[i], -1);
+        bigint_t* q = power_of_two(exponents[i], 1);
+        ck_assert(bigint_is_probab_prime(p, 1));
+        ck_assert(!bigint_is_probab_prime(q, 1));
+
+        // Products of two large primes
+        ck_assert(bigint_mul(q, p, p));
+        ck_assert(!bigint_is_probab_prime(q, 0));
+
+        bigint_delete(p);
+        bigint_delete(q);
+    }
+
+    // 2^89 - 1 times 2^127 - 1 has no small factor for the sieve to catch
+    bigint_t* a = power_of_two(89, -1);
+    bigint_t* b = power_of_two(127, -1);
+    ck_assert(bigint_mul(a, a, b));
+    ck_assert(!bigint_is_probab_prime(a, 0));
+
+    bigint_delete(a);
+    bigint_delete(b);
+}
+END_TEST
+
+START_TEST(test_bigint_next_prime)
+{
+    bigint_t* n = bigint_new();
+    bigint_t* p = bigint_new();
+
+    // Small values step through the primes
+    uint32_t small[7][2] = {
+        { 0, 2 }, { 1, 2 }, { 2, 3 }, { 3, 5 }, { 24, 29 }, { 7919, 7927 }, { 4194301, 4194319 }
+    };
+
+    for (size_t i = 0; i < 7; i++) {
+        ck_assert(bigint_set_u32(n, small[i][0]));
+        ck_assert(bigint_next_prime(p, n));
+        ck_assert(bigint_get_u64(p) == small[i][1] && bigint_bitlen(p) <= 32);
+    }
+
+    // First primes above some powers of two
+    size_t bits[3]    = { 64, 128, 521 };
+    int    offsets[3] = { 13, 51, 887 };
+
+    for (size_t i = 0; i < 3; i++) {
+        bigint_t* start    = power_of_two(bits[i], 0);
+        bigint_t* expected = power_of_two(bits[i], offsets[i]);
+
+        ck_assert(bigint_next_prime(p, start));
+        ck_assert(bigint_cmp(p, expected) == 0);
+
+        // In place, and strictly above a prime
+        ck_assert(bigint_next_prime(start, start));
+        ck_assert(bigint_cmp(start, expected) == 0);
+        ck_assert(bigint_next_prime(p, expected));
+        ck_assert(bigint_cmp(p, expected) > 0);
+        ck_assert(bigint_is_probab_prime(p, 0));
+
+        bigint_delete(start);
+        bigint_delete(expected);
+    }
+
+    bigint_delete(n);
+    bigint_delete(p);
+}
+END_TEST
+
+Suite* bigint_prime_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntPrime");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_is_probab_prime_small);
+    tcase_add_test(tc_core, test_bigint_is_probab_prime_large);
+    tcase_add_test(tc_core, test_bigint_next_prime);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    Suite*   s  = bigint_prime_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
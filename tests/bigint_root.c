@@ -0,0 +1,190 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<time.h>
+#include<bigint_root.h>
+#include<stdio.h>
+
+#include "random.h"
+
+Suite* bigint_root_suite(void);
+
+START_TEST(test_bigint_sqrt_small)
+{
+    bigint_t* a = bigint_new();
+    bigint_t* s = bigint_new();
+    bigint_t* r = bigint_new();
+
+    for (uint64_t x = 0; x < 2000; x++) {
+        bigint_set_u64(a, x);
+        ck_assert(bigint_sqrtrem(s, r, a));
+
+        uint64_t root = bigint_get_u64(s);
+        ck_assert(root * root <= x);
+        ck_assert((root + 1) * (root + 1) > x);
+        ck_assert(bigint_get_u64(r) == x - root * root);
+        ck_assert(bigint_is_square(a) == (root * root == x));
+    }
+
+    // Biggest 64 bit value
+    bigint_set_u64(a, UINT64_MAX);
+    ck_assert(bigint_sqrt(s, a));
+    ck_assert(bigint_get_u64(s) == 0xFFFFFFFF);
+
+    bigint_delete(a);
+    bigint_delete(s);
+    bigint_delete(r);
+}
+END_TEST
+
+START_TEST(test_bigint_sqrt_large)
+{
+    bigint_t* s  = bigint_new();
+    bigint_t* r  = bigint_new();
+    bigint_t* sq = bigint_new();
+
+    for (size_t limbs = 3; limbs < 200; limbs += 7) {
+        bigint_t* a = random_number(limbs);
+
+        // s^2 <= a < (s + 1)^2 and r = a - s^2
+        ck_assert(bigint_sqrtrem(s, r, a));
+        ck_assert(bigint_mul(sq, s, s));
+        ck_assert(bigint_add(sq, sq, r));
+        ck_assert(bigint_cmp(sq, a) == 0);
+        ck_assert(bigint_add_u32(sq, s, 1));
+        ck_assert(bigint_mul(sq, sq, sq));
+        ck_assert(bigint_cmp(sq, a) > 0);
+
+        // Squares are recognized, their neighbours aren't
+        ck_assert(bigint_mul(sq, a, a));
+        ck_assert( bigint_is_square(sq));
+        ck_assert(bigint_sqrt(s, sq));
+        ck_assert(bigint_cmp(s, a) == 0);
+        ck_assert(bigint_add_u32(sq, sq, 1));
+        ck_assert(!bigint_is_square(sq));
+        ck_assert(bigint_sub_u32(sq, sq, 2));
+        ck_assert(!bigint_is_square(sq));
+
+        bigint_delete(a);
+    }
+
+    bigint_delete(s);
+    bigint_delete(r);
+    bigint_delete(sq);
+}
+END_TEST
+
+START_TEST(test_bigint_root)
+{
+    bigint_t* x = bigint_new();
+    bigint_t* p = bigint_new();
+
+    for (uint32_t n = 3; n < 40; n += 4) {
+        bigint_t* a = random_number(1 + n % 5);
+
+        // Exact powers come back exactly, one less gives one less
+        ck_assert(bigint_pow_u32(p, a, n));
+        ck_assert(bigint_root(x, p, n));
+        ck_assert(bigint_cmp(x, a) == 0);
+
+        ck_assert(bigint_sub_u32(p, p, 1));
+        ck_assert(bigint_root(x, p, n));
+        ck_assert(bigint_add_u32(x, x, 1));
+        ck_assert(bigint_cmp(x, a) == 0);
+
+        bigint_delete(a);
+    }
+
+    ck_assert(!bigint_root(x, p, 0));
+
+    // Roots past the bit length are 1 without any powers of that size, the
+    // one just below it is 2
+    bigint_t* a = random_number(100);
+    bigint_setbit(a, 3199, 1);
+
+    uint32_t huge[3] = { UINT32_MAX, 1u << 20, 3200 };
+    for (size_t i = 0; i < 3; i++) {
+        ck_assert(bigint_root(x, a, huge[i]));
+        ck_assert(bigint_bitlen(x) == 1);
+    }
+
+    ck_assert(bigint_root(x, a, 3199));
+    ck_assert(bigint_get_u64(x) == 2 && bigint_bitlen(x) == 2);
+
+    ck_assert(bigint_set_u32(a, 0));
+    ck_assert(bigint_root(x, a, UINT32_MAX));
+    ck_assert(bigint_is_zero(x));
+    bigint_delete(a);
+
+    bigint_delete(x);
+    bigint_delete(p);
+}
+END_TEST
+
+START_TEST(test_bigint_is_perfect_power)
+{
+    bigint_t* a = bigint_new();
+    bigint_t* b = bigint_new();
+
+    ck_assert(bigint_set_u32(a, 0) && bigint_is_perfect_power(a));
+    ck_assert(bigint_set_u32(a, 1) && bigint_is_perfect_power(a));
+    ck_assert(bigint_set_u32(a, 8) && bigint_is_perfect_power(a));
+    ck_assert(bigint_set_u32(a, 243) && bigint_is_perfect_power(a));
+    ck_assert(bigint_set_u32(a, 2) && !bigint_is_perfect_power(a));
+    ck_assert(bigint_set_u32(a, 72) && !bigint_is_perfect_power(a));
+
+    // 7^101, a prime exponent with a small root
+    ck_assert(bigint_set_u32(b, 7));
+    ck_assert(bigint_pow_u32(a, b, 101));
+    ck_assert(bigint_is_perfect_power(a));
+    ck_assert(bigint_add_u32(a, a, 2));
+    ck_assert(!bigint_is_perfect_power(a));
+
+    // A big root to a small exponent
+    ck_assert(bigint_set_u64(b, 0xFFFFFFFFFFFFFFC5ull));
+    ck_assert(bigint_pow_u32(b, b, 3));
+    ck_assert(bigint_pow_u32(a, b, 5));
+    ck_assert(bigint_is_perfect_power(a));
+    ck_assert(bigint_mul_u32(a, a, 3));
+    ck_assert(!bigint_is_perfect_power(a));
+
+    bigint_delete(a);
+    bigint_delete(b);
+}
+END_TEST
+
+Suite* bigint_root_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntRoot");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_sqrt_small);
+    tcase_add_test(tc_core, test_bigint_sqrt_large);
+    tcase_add_test(tc_core, test_bigint_root);
+    tcase_add_test(tc_core, test_bigint_is_perfect_power);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_root_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
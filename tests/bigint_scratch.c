@@ -0,0 +1,184 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<pthread.h>
+#include<string.h>
+#include<time.h>
+#include<bigint.h>
+#include<bigint_io.h>
+#include<bigint_scratch.h>
+#include<bigint_tune.h>
+
+#include "random.h"
+
+Suite* bigint_scratch_suite(void);
+
+// a b / b, in place, back to a.
+static bool multiply_and_divide(size_t an, size_t bn)
+{
+    bigint_t* a = random_number(an);
+    bigint_t* b = random_number(bn);
+    bigint_t* c = bigint_new();
+
+    bool ok = bigint_mul(c, a, b)
+           && bigint_divmod(c, NULL, c, b)
+           && bigint_equals(c, a);
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(c);
+    return ok;
+}
+
+START_TEST(test_bigint_scratch_reuse)
+{
+    bigint_scratch_release();
+    ck_assert_uint_eq(bigint_scratch_capacity(), 0);
+
+    bigint_scratch_reset_high_water();
+    ck_assert(multiply_and_divide(400, 300));
+
+    // Sized up front, nothing went on the side
+    size_t capacity = bigint_scratch_capacity();
+    ck_assert(capacity > 0);
+    ck_assert_uint_eq(bigint_scratch_high_water(), capacity);
+
+    for (int i = 0; i < 5; i++) {
+        ck_assert(multiply_and_divide(400, 300));
+        ck_assert(multiply_and_divide(40, 30));
+    }
+    ck_assert_uint_eq(bigint_scratch_capacity(), capacity);
+    ck_assert_uint_eq(bigint_scratch_high_water(), capacity);
+
+    bigint_scratch_reset_high_water();
+    ck_assert(multiply_and_divide(40, 30));
+    ck_assert(bigint_scratch_high_water() < capacity);
+
+    bigint_scratch_release();
+    ck_assert_uint_eq(bigint_scratch_capacity(), 0);
+}
+END_TEST
+
+START_TEST(test_bigint_scratch_reserve)
+{
+    bigint_scratch_release();
+
+    ck_assert(bigint_scratch_reserve(1 << 16));
+    ck_assert(bigint_scratch_capacity() >= 1 << 16);
+
+    size_t capacity = bigint_scratch_capacity();
+    ck_assert(multiply_and_divide(100, 50));
+    ck_assert_uint_eq(bigint_scratch_capacity(), capacity);
+
+    // Never shrinks
+    ck_assert(bigint_scratch_reserve(16));
+    ck_assert_uint_eq(bigint_scratch_capacity(), capacity);
+
+    bigint_scratch_release();
+    ck_assert_uint_eq(bigint_scratch_capacity(), 0);
+}
+END_TEST
+
+START_TEST(test_bigint_scratch_radix)
+{
+    size_t    saved = bigint_threshold_get(BIGINT_THRESHOLD_RADIX_DC);
+    bigint_t* a     = random_number(500);
+    bigint_t* b     = bigint_new();
+
+    // 10^k - 1 is all nines, divide and conquer splits it into zero runs.
+    bigint_set_u32(b, 10);
+    bigint_pow_u32(b, b, 4000);
+    bigint_sub_u32(b, b, 1);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, 0);
+    char* small = bigint_to_string(a, 10);
+    char* nines = bigint_to_string(b, 10);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, 100000);
+    char* basecase = bigint_to_string(a, 10);
+
+    ck_assert_str_eq(small, basecase);
+    ck_assert_uint_eq(strlen(nines), 4000);
+    ck_assert_uint_eq(strspn(nines, "9"), 4000);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, saved);
+    free(small);
+    free(nines);
+    free(basecase);
+    bigint_delete(a);
+    bigint_delete(b);
+}
+END_TEST
+
+static void* scratch_thread(void* arg)
+{
+    size_t* capacity = arg;
+    bool    ok       = true;
+
+    for (int i = 0; i < 20; i++) {
+        ok = ok && multiply_and_divide(200 + (size_t) i, 100);
+    }
+
+    *capacity = ok ? bigint_scratch_capacity() : 0;
+    return NULL;
+}
+
+START_TEST(test_bigint_scratch_threads)
+{
+    pthread_t threads[4];
+    size_t    capacity[4];
+
+    bigint_scratch_release();
+    bigint_scratch_reset_high_water();
+
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, scratch_thread, &capacity[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Each thread had a stack of its own, this one still has none
+    for (int i = 0; i < 4; i++) {
+        ck_assert(capacity[i] > 0);
+        ck_assert(bigint_scratch_high_water() >= capacity[i]);
+    }
+    ck_assert_uint_eq(bigint_scratch_capacity(), 0);
+}
+END_TEST
+
+Suite* bigint_scratch_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntScratch");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_scratch_reuse);
+    tcase_add_test(tc_core, test_bigint_scratch_reserve);
+    tcase_add_test(tc_core, test_bigint_scratch_radix);
+    tcase_add_test(tc_core, test_bigint_scratch_threads);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_scratch_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
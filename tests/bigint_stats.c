@@ -0,0 +1,255 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<pthread.h>
+#include<string.h>
+#include<time.h>
+#include<bigint.h>
+#include<bigint_gcd.h>
+#include<bigint_mont.h>
+#include<bigint_scratch.h>
+#include<bigint_stats.h>
+#include<bigint_tune.h>
+
+#include "random.h"
+
+Suite* bigint_stats_suite(void);
+
+static void multiply_some(void)
+{
+    bigint_t* a = random_number(200);
+    bigint_t* b = random_number(100);
+    bigint_t* c = bigint_new();
+
+    for (int i = 0; i < 10; i++) {
+        bigint_mul(c, a, b);
+    }
+
+    bigint_delete(a);
+    bigint_delete(b);
+    bigint_delete(c);
+}
+
+START_TEST(test_bigint_stats_names)
+{
+    ck_assert_str_eq(bigint_stat_name(BIGINT_STAT_ADD), "ADD");
+    ck_assert_str_eq(bigint_stat_name(BIGINT_STAT_MUL_KARATSUBA), "MUL_KARATSUBA");
+    ck_assert_str_eq(bigint_stat_name(BIGINT_STAT_UNSHARE_COPY), "UNSHARE_COPY");
+}
+END_TEST
+
+START_TEST(test_bigint_stats_counts)
+{
+    bigint_stat_value_t values[BIGINT_STATS];
+
+    bigint_stats_reset();
+    multiply_some();
+    bigint_stats_read(values);
+
+    if (!bigint_stats_enabled()) {
+        // Compiled out, nothing is ever counted
+        for (int i = 0; i < BIGINT_STATS; i++) {
+            ck_assert_uint_eq(values[i].calls, 0);
+            ck_assert_uint_eq(values[i].units, 0);
+        }
+        return;
+    }
+
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].calls, 10);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].units, 3000);
+    ck_assert(values[BIGINT_STAT_MUL].nanoseconds > 0);
+
+    // The operands, the product and maybe the scratch stack, the product's
+    // buffer and the scratch are reused by the next nine
+    ck_assert(values[BIGINT_STAT_ALLOC].calls >= 3);
+    ck_assert(values[BIGINT_STAT_ALLOC].calls <= 4);
+    ck_assert(values[BIGINT_STAT_ALLOC].units >= 600 * sizeof(uint32_t));
+
+    // Once warm, nothing is allocated at all
+    bigint_t* x = random_number(200);
+    bigint_t* y = random_number(100);
+    bigint_t* z = bigint_new();
+
+    ck_assert(bigint_mul(z, x, y));
+    bigint_stats_reset();
+    for (int i = 0; i < 10; i++) {
+        ck_assert(bigint_mul(z, x, y));
+    }
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].calls, 10);
+    ck_assert_uint_eq(values[BIGINT_STAT_ALLOC].calls, 0);
+    ck_assert_uint_eq(values[BIGINT_STAT_FREE].calls, 0);
+
+    bigint_delete(x);
+    bigint_delete(y);
+    bigint_delete(z);
+
+    // Which tier ran follows the threshold
+    size_t saved = bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 1000);
+    bigint_stats_reset();
+    multiply_some();
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL_KARATSUBA].calls, 0);
+    ck_assert(values[BIGINT_STAT_MUL_BASECASE].calls > 0);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 0);
+    bigint_stats_reset();
+    multiply_some();
+    bigint_stats_read(values);
+    ck_assert(values[BIGINT_STAT_MUL_KARATSUBA].calls > 0);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, saved);
+
+    // Growing within capacity doesn't allocate, beyond it does
+    bigint_t* a = bigint_new();
+    bigint_resize(a, 8);
+    ARRAY_RESIZE_R(a, 4);
+
+    bigint_stats_reset();
+    bigint_resize(a, 6);
+    bigint_resize(a, 16);
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_RESIZE_INPLACE].calls, 1);
+    ck_assert_uint_eq(values[BIGINT_STAT_RESIZE_REALLOC].calls, 1);
+    ck_assert_uint_eq(values[BIGINT_STAT_ALLOC].calls, 1);
+    ck_assert_uint_eq(values[BIGINT_STAT_ALLOC].units, 16 * sizeof(uint32_t));
+    ck_assert_uint_eq(values[BIGINT_STAT_FREE].calls, 1);
+
+    // Writing to a shared copy copies it
+    bigint_t* b = array_share(a);
+    bigint_stats_reset();
+    bigint_add_u32(b, b, 1);
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_UNSHARE_COPY].calls, 1);
+    ck_assert_uint_eq(values[BIGINT_STAT_ADD].calls, 1);
+
+    bigint_delete(a);
+    bigint_delete(b);
+}
+END_TEST
+
+static void* stats_thread(void* arg)
+{
+    (void) arg;
+    multiply_some();
+    bigint_scratch_reserve(4096);
+    return NULL;
+}
+
+START_TEST(test_bigint_stats_threads)
+{
+    bigint_stat_value_t values[BIGINT_STATS];
+    pthread_t           threads[4];
+
+    bigint_stats_reset();
+
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, stats_thread, NULL);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Exited threads' counts are kept, their scratch stacks freed with them
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].calls, bigint_stats_enabled() ? 40 : 0);
+    ck_assert_uint_eq(values[BIGINT_STAT_FREE].calls, values[BIGINT_STAT_ALLOC].calls);
+    ck_assert_uint_eq(values[BIGINT_STAT_FREE].units, values[BIGINT_STAT_ALLOC].units);
+
+    multiply_some();
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].calls, bigint_stats_enabled() ? 50 : 0);
+
+    bigint_stats_reset();
+    bigint_stats_read(values);
+    ck_assert_uint_eq(values[BIGINT_STAT_MUL].calls, 0);
+}
+END_TEST
+
+typedef struct trace_s
+{
+    size_t begins;
+    size_t ends;
+    size_t counts;
+} trace_t;
+
+static void trace_hook(bigint_stat_t stat, bigint_trace_t event, uint64_t units, void* data)
+{
+    trace_t* trace = data;
+
+    if (stat == BIGINT_STAT_POWM) {
+        ck_assert_uint_eq(units, 4);
+        trace->begins += event == BIGINT_TRACE_BEGIN;
+        trace->ends   += event == BIGINT_TRACE_END;
+    }
+    if (stat == BIGINT_STAT_POWM_MONT) {
+        trace->counts += event == BIGINT_TRACE_COUNT;
+    }
+}
+
+START_TEST(test_bigint_stats_hook)
+{
+    trace_t   trace    = { 0, 0, 0 };
+    bigint_t* base     = random_number(4);
+    bigint_t* exponent = random_number(4);
+    bigint_t* modulus  = random_number(4);
+    bigint_t* result   = bigint_new();
+
+    // Odd, so it goes through Montgomery
+    bigint_setbit(modulus, 0, 1);
+
+    bigint_stats_set_hook(trace_hook, &trace);
+    bigint_powm(result, base, exponent, modulus);
+    bigint_powm(result, base, exponent, modulus);
+    bigint_stats_set_hook(NULL, NULL);
+    bigint_powm(result, base, exponent, modulus);
+
+    size_t expected = bigint_stats_enabled() ? 2 : 0;
+    ck_assert_uint_eq(trace.begins, expected);
+    ck_assert_uint_eq(trace.ends, expected);
+    ck_assert_uint_eq(trace.counts, expected);
+
+    bigint_delete(base);
+    bigint_delete(exponent);
+    bigint_delete(modulus);
+    bigint_delete(result);
+}
+END_TEST
+
+Suite* bigint_stats_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntStats");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_stats_names);
+    tcase_add_test(tc_core, test_bigint_stats_counts);
+    tcase_add_test(tc_core, test_bigint_stats_threads);
+    tcase_add_test(tc_core, test_bigint_stats_hook);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_stats_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
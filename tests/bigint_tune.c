@@ -0,0 +1,144 @@
+#include<stdlib.h>
+#include<stdbool.h>
+#include<check.h>
+
+#include<string.h>
+#include<time.h>
+#include<bigint_io.h>
+#include<bigint_tune.h>
+#include<stdio.h>
+
+#include "random.h"
+
+Suite* bigint_tune_suite(void);
+
+START_TEST(test_bigint_threshold_set)
+{
+    size_t saved = bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA);
+
+    ck_assert_str_eq(bigint_threshold_name(BIGINT_THRESHOLD_MUL_KARATSUBA), "MUL_KARATSUBA");
+    ck_assert_str_eq(bigint_threshold_name(BIGINT_THRESHOLD_RADIX_DC), "RADIX_DC");
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 100);
+    ck_assert_uint_eq(bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA), 100);
+
+    // Karatsuba can't split anything shorter than a few limbs
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 0);
+    ck_assert(bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA) > 1);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, saved);
+}
+END_TEST
+
+START_TEST(test_bigint_mul_thresholds)
+{
+    size_t sizes[8][2] = {
+        { 5, 5 }, { 6, 5 }, { 17, 9 }, { 40, 40 }, { 63, 64 }, { 100, 7 }, { 257, 130 }, { 300, 31 }
+    };
+
+    size_t    mul      = bigint_threshold_get(BIGINT_THRESHOLD_MUL_KARATSUBA);
+    size_t    sqr      = bigint_threshold_get(BIGINT_THRESHOLD_SQR_KARATSUBA);
+    bigint_t* expected = bigint_new();
+    bigint_t* product  = bigint_new();
+
+    for (size_t i = 0; i < 8; i++) {
+        bigint_t* a = random_number(sizes[i][0]);
+        bigint_t* b = random_number(sizes[i][1]);
+
+        // Schoolbook all the way down against Karatsuba all the way down
+        bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, SIZE_MAX);
+        bigint_threshold_set(BIGINT_THRESHOLD_SQR_KARATSUBA, SIZE_MAX);
+        ck_assert(bigint_mul(expected, a, b));
+        bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, 0);
+        ck_assert(bigint_mul(product, a, b));
+        ck_assert(bigint_cmp(product, expected) == 0);
+
+        ck_assert(bigint_mul(expected, a, a));
+        bigint_threshold_set(BIGINT_THRESHOLD_SQR_KARATSUBA, 0);
+        ck_assert(bigint_mul(product, a, a));
+        ck_assert(bigint_cmp(product, expected) == 0);
+
+        // Squaring and multiplying agree
+        ck_assert(bigint_copy(b, a));
+        ck_assert(bigint_mul(expected, a, b));
+        ck_assert(bigint_cmp(product, expected) == 0);
+
+        bigint_delete(a);
+        bigint_delete(b);
+    }
+
+    // All ones is the worst case for the carries
+    bigint_t* ones = bigint_new();
+    ck_assert(bigint_set_u32(ones, 1));
+    ck_assert(bigint_shl(ones, ones, 32 * 77));
+    ck_assert(bigint_sub_u32(ones, ones, 1));
+    ck_assert(bigint_mul(product, ones, ones));
+    bigint_threshold_set(BIGINT_THRESHOLD_SQR_KARATSUBA, SIZE_MAX);
+    ck_assert(bigint_mul(expected, ones, ones));
+    ck_assert(bigint_cmp(product, expected) == 0);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_MUL_KARATSUBA, mul);
+    bigint_threshold_set(BIGINT_THRESHOLD_SQR_KARATSUBA, sqr);
+
+    bigint_delete(ones);
+    bigint_delete(expected);
+    bigint_delete(product);
+}
+END_TEST
+
+START_TEST(test_bigint_radix_thresholds)
+{
+    size_t    saved = bigint_threshold_get(BIGINT_THRESHOLD_RADIX_DC);
+    bigint_t* a     = random_number(150);
+
+    bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, SIZE_MAX);
+    char* expected = bigint_to_string(a, 10);
+
+    size_t thresholds[4] = { 0, 2, 9, 64 };
+    for (size_t i = 0; i < 4; i++) {
+        bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, thresholds[i]);
+        char* digits = bigint_to_string(a, 10);
+        ck_assert_str_eq(digits, expected);
+        free(digits);
+    }
+
+    bigint_threshold_set(BIGINT_THRESHOLD_RADIX_DC, saved);
+
+    free(expected);
+    bigint_delete(a);
+}
+END_TEST
+
+Suite* bigint_tune_suite(void)
+{
+    Suite* s;
+    TCase* tc_core;
+
+    s = suite_create("BigIntTune");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bigint_threshold_set);
+    tcase_add_test(tc_core, test_bigint_mul_thresholds);
+    tcase_add_test(tc_core, test_bigint_radix_thresholds);
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    srand((unsigned int) time(NULL));
+
+    Suite*   s  = bigint_tune_suite();
+    SRunner* sr = srunner_create(s);
+
+    // TODO: Remove if not debugging!
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    int failed = srunner_ntests_failed(sr);
+
+    srunner_free(sr);
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
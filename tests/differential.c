@@ -0,0 +1,379 @@
+#include "differential.h"
+#include "reference.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include<bigint_gcd.h>
+#include<bigint_io.h>
+#include<bigint_mont.h>
+#include<bigint_root.h>
+
+static const char* const differential_op_names[DIFFERENTIAL_OPS] = {
+    "add",
+    "sub",
+    "mul",
+    "sqr",
+    "mul_u32",
+    "divmod",
+    "divmod_u32",
+    "shl",
+    "shr",
+    "cmp",
+    "to_string",
+    "gcd",
+    "gcdext",
+    "invert",
+    "powm",
+    "root",
+};
+
+const char* differential_op_name(differential_op_t op)
+{
+    return differential_op_names[op];
+}
+
+// Operands as the reference sees them, taken before anything is overwritten.
+typedef struct differential_state_s
+{
+    const differential_case_t* test;
+    reference_t                a;
+    reference_t                b;
+    reference_t                c;
+} differential_state_t;
+
+static bool differential_fail(differential_state_t* st, const char* what)
+{
+    char* a = reference_to_string(&st->a, 16);
+    char* b = reference_to_string(&st->b, 16);
+    char* c = reference_to_string(&st->c, 16);
+
+    fprintf(stderr,
+        "%s (alias %d, small %u): %s\n  a = 0x%s\n  b = 0x%s\n  c = 0x%s\n",
+        differential_op_name(st->test->op), (int) st->test->alias, st->test->small, what, a, b, c);
+
+    free(a);
+    free(b);
+    free(c);
+    return false;
+}
+
+// Checks `number` against `expected` and frees expected.
+static bool differential_expect(differential_state_t* st, bigint_t* number, reference_t expected, const char* what)
+{
+    bool equal = reference_equals(&expected, number);
+
+    if (!equal) {
+        char* got  = bigint_to_string(number, 16);
+        char* want = reference_to_string(&expected, 16);
+
+        fprintf(stderr, "  got  0x%s\n  want 0x%s\n", got != NULL ? got : "?", want);
+        free(got);
+        free(want);
+    }
+
+    reference_free(&expected);
+    return equal || differential_fail(st, what);
+}
+
+static bool differential_run(differential_state_t* st, bigint_t* out, bigint_t* extra)
+{
+    const differential_case_t* test = st->test;
+    reference_t*               a    = &st->a;
+    reference_t*               b    = &st->b;
+    reference_t*               c    = &st->c;
+    bigint_t*                  x    = test->a;
+    bigint_t*                  y    = test->b;
+
+    switch (test->op) {
+        case DIFFERENTIAL_ADD:
+            if (!bigint_add(out, x, y)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_add(a, b), "sum");
+
+        case DIFFERENTIAL_SUB:
+            if (reference_cmp(a, b) < 0) {
+                return !bigint_sub(out, x, y) || differential_fail(st, "negative difference accepted");
+            }
+            if (!bigint_sub(out, x, y)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_sub(a, b), "difference");
+
+        case DIFFERENTIAL_MUL:
+            if (!bigint_mul(out, x, y)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_mul(a, b), "product");
+
+        case DIFFERENTIAL_SQR:
+            if (!bigint_mul(out, x, x)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_mul(a, a), "square");
+
+        case DIFFERENTIAL_MUL_U32: {
+            reference_t small = reference_from_u32(test->small);
+            reference_t expected = reference_mul(a, &small);
+
+            reference_free(&small);
+            if (!bigint_mul_u32(out, x, test->small)) {
+                reference_free(&expected);
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, expected, "product");
+        }
+
+        case DIFFERENTIAL_DIVMOD: {
+            if (reference_is_zero(b)) {
+                return !bigint_divmod(out, extra, x, y) || differential_fail(st, "division by zero accepted");
+            }
+
+            reference_t q, r;
+            reference_divmod(&q, &r, a, b);
+
+            if (!bigint_divmod(out, extra, x, y)) {
+                reference_free(&q);
+                reference_free(&r);
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, q, "quotient")
+                && differential_expect(st, extra, r, "remainder");
+        }
+
+        case DIFFERENTIAL_DIVMOD_U32: {
+            uint32_t rem;
+
+            if (test->small == 0) {
+                return !bigint_divmod_u32(out, &rem, x, 0) || differential_fail(st, "division by zero accepted");
+            }
+
+            reference_t d = reference_from_u32(test->small);
+            reference_t q, r;
+            reference_divmod(&q, &r, a, &d);
+            reference_free(&d);
+
+            if (!bigint_divmod_u32(out, &rem, x, test->small)) {
+                reference_free(&q);
+                reference_free(&r);
+                return differential_fail(st, "failed");
+            }
+
+            bigint_t* remainder = bigint_new();
+            bool      ok        = remainder != NULL && bigint_set_u32(remainder, rem);
+
+            ok = ok && differential_expect(st, out, q, "quotient")
+                    && differential_expect(st, remainder, r, "remainder");
+
+            if (remainder != NULL) {
+                bigint_delete(remainder);
+            }
+            return ok;
+        }
+
+        case DIFFERENTIAL_SHL:
+            if (!bigint_shl(out, x, test->small)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_shl(a, test->small), "shifted");
+
+        case DIFFERENTIAL_SHR:
+            if (!bigint_shr(out, x, test->small)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_shr(a, test->small), "shifted");
+
+        case DIFFERENTIAL_CMP: {
+            int got  = bigint_cmp(x, y);
+            int want = reference_cmp(a, b);
+
+            if ((got > 0) != (want > 0) || (got < 0) != (want < 0)) {
+                return differential_fail(st, "order");
+            }
+            return bigint_equals(x, y) == (want == 0) || differential_fail(st, "equality");
+        }
+
+        case DIFFERENTIAL_TO_STRING: {
+            char* got = bigint_to_string(x, test->small);
+
+            if (test->small < 2 || test->small > 36) {
+                bool rejected = got == NULL;
+                free(got);
+                return rejected || differential_fail(st, "bad base accepted");
+            }
+            if (got == NULL) {
+                return differential_fail(st, "failed");
+            }
+
+            char* want  = reference_to_string(a, test->small);
+            bool  equal = strcmp(got, want) == 0;
+
+            if (!equal) {
+                fprintf(stderr, "  got  %s\n  want %s\n", got, want);
+            }
+
+            free(got);
+            free(want);
+            return equal || differential_fail(st, "digits");
+        }
+
+        case DIFFERENTIAL_GCD:
+            if (!bigint_gcd(out, x, y)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_gcd(a, b), "gcd");
+
+        case DIFFERENTIAL_GCDEXT: {
+            if (!bigint_gcdext(out, extra, x, y)) {
+                return differential_fail(st, "failed");
+            }
+
+            // s isn't unique, check a s = g (mod b) and 0 <= s < b / g instead.
+            reference_t g = reference_gcd(a, b);
+            reference_t s = reference_from_bigint(extra);
+            bool        ok;
+
+            if (reference_is_zero(&g)) {
+                ok = reference_is_zero(&s);
+            } else if (reference_is_zero(b)) {
+                // Only a s = g itself pins s down.
+                reference_t as = reference_mul(a, &s);
+                ok = reference_cmp(&as, &g) == 0;
+                reference_free(&as);
+            } else {
+                reference_t bound, as, lhs, rhs;
+                reference_divmod(&bound, NULL, b, &g);
+                as = reference_mul(a, &s);
+                reference_divmod(NULL, &lhs, &as, b);
+                reference_divmod(NULL, &rhs, &g, b);
+
+                ok = reference_cmp(&lhs, &rhs) == 0
+                  && (reference_cmp(&s, &bound) < 0 || (reference_is_zero(&s) && reference_is_zero(&bound)));
+
+                reference_free(&bound);
+                reference_free(&as);
+                reference_free(&lhs);
+                reference_free(&rhs);
+            }
+
+            reference_free(&s);
+            return differential_expect(st, out, g, "gcd")
+                && (ok || differential_fail(st, "cofactor"));
+        }
+
+        case DIFFERENTIAL_INVERT: {
+            reference_t g      = reference_gcd(a, b);
+            reference_t one    = reference_from_u32(1);
+            bool        exists = !reference_is_zero(b) && reference_cmp(&g, &one) == 0;
+
+            reference_free(&g);
+
+            if (!exists) {
+                reference_free(&one);
+                return !bigint_invert(out, x, y) || differential_fail(st, "inverse where none exists");
+            }
+            if (!bigint_invert(out, x, y)) {
+                reference_free(&one);
+                return differential_fail(st, "failed");
+            }
+
+            // a r = 1 (mod b), with r < b.
+            reference_t r  = reference_from_bigint(out);
+            reference_t ar = reference_mul(a, &r);
+            reference_t lhs, rhs;
+            reference_divmod(NULL, &lhs, &ar, b);
+            reference_divmod(NULL, &rhs, &one, b);
+
+            bool ok = reference_cmp(&lhs, &rhs) == 0 && reference_cmp(&r, b) < 0;
+
+            reference_free(&one);
+            reference_free(&r);
+            reference_free(&ar);
+            reference_free(&lhs);
+            reference_free(&rhs);
+            return ok || differential_fail(st, "inverse");
+        }
+
+        case DIFFERENTIAL_POWM:
+            if (reference_is_zero(c)) {
+                return !bigint_powm(out, x, y, test->c) || differential_fail(st, "zero modulus accepted");
+            }
+            if (!bigint_powm(out, x, y, test->c)) {
+                return differential_fail(st, "failed");
+            }
+            return differential_expect(st, out, reference_powm(a, b, c), "power");
+
+        case DIFFERENTIAL_ROOT: {
+            if (test->small == 0) {
+                return !bigint_root(out, x, 0) || differential_fail(st, "zeroth root accepted");
+            }
+
+            bool ok = test->small == 2 ? bigint_sqrtrem(out, extra, x) : bigint_root(out, x, test->small);
+            if (!ok) {
+                return differential_fail(st, "failed");
+            }
+
+            // r^n <= a < (r + 1)^n, and a - r^2 for the square root.
+            reference_t one  = reference_from_u32(1);
+            reference_t r    = reference_from_bigint(out);
+            reference_t r1   = reference_add(&r, &one);
+            reference_t low  = reference_pow_u32(&r, test->small);
+            reference_t high = reference_pow_u32(&r1, test->small);
+
+            ok = reference_cmp(&low, a) <= 0 && reference_cmp(a, &high) < 0;
+
+            if (ok && test->small == 2) {
+                ok = differential_expect(st, extra, reference_sub(a, &low), "remainder");
+            }
+
+            reference_free(&one);
+            reference_free(&r);
+            reference_free(&r1);
+            reference_free(&low);
+            reference_free(&high);
+            return ok || differential_fail(st, "root");
+        }
+
+        default:
+            return false;
+    }
+}
+
+bool differential_check(const differential_case_t* test)
+{
+    differential_state_t st = { test, { NULL, 0 }, { NULL, 0 }, { NULL, 0 } };
+
+    st.a = reference_from_bigint(test->a);
+    st.b = reference_from_bigint(test->b);
+    st.c = test->c != NULL ? reference_from_bigint(test->c) : reference_from_u32(0);
+
+    // The second result, where there is one, goes to b when aliasing it.
+    bigint_t* fresh  = bigint_new();
+    bigint_t* second = bigint_new();
+    bigint_t* out    = test->alias == DIFFERENTIAL_INTO_A ? test->a : fresh;
+    bigint_t* extra  = second;
+
+    if (test->alias == DIFFERENTIAL_INTO_B) {
+        if (test->op == DIFFERENTIAL_DIVMOD || test->op == DIFFERENTIAL_GCDEXT || test->op == DIFFERENTIAL_ROOT) {
+            extra = test->b;
+        } else {
+            out = test->b;
+        }
+    }
+
+    bool ok = fresh != NULL && second != NULL && differential_run(&st, out, extra);
+
+    if (fresh != NULL) {
+        bigint_delete(fresh);
+    }
+    if (second != NULL) {
+        bigint_delete(second);
+    }
+
+    reference_free(&st.a);
+    reference_free(&st.b);
+    reference_free(&st.c);
+    return ok;
+}
@@ -0,0 +1,58 @@
+#ifndef DIFFERENTIAL_H
+#define DIFFERENTIAL_H
+
+// Runs one library operation and checks it against reference.h, shared by
+// the randomized test and the fuzzing harness. Whatever thresholds are set
+// in bigint_tune.h at the time are the ones exercised.
+
+#include<stdbool.h>
+#include<stdint.h>
+
+#include<bigint.h>
+
+typedef enum differential_op_e
+{
+    DIFFERENTIAL_ADD = 0,
+    DIFFERENTIAL_SUB,
+    DIFFERENTIAL_MUL,
+    DIFFERENTIAL_SQR,
+    DIFFERENTIAL_MUL_U32,
+    DIFFERENTIAL_DIVMOD,
+    DIFFERENTIAL_DIVMOD_U32,
+    DIFFERENTIAL_SHL,
+    DIFFERENTIAL_SHR,
+    DIFFERENTIAL_CMP,
+    DIFFERENTIAL_TO_STRING,
+    DIFFERENTIAL_GCD,
+    DIFFERENTIAL_GCDEXT,
+    DIFFERENTIAL_INVERT,
+    DIFFERENTIAL_POWM,
+    DIFFERENTIAL_ROOT,
+    DIFFERENTIAL_OPS,
+} differential_op_t;
+
+// Where the result goes. Aliased operands are overwritten.
+typedef enum differential_alias_e
+{
+    DIFFERENTIAL_FRESH = 0,
+    DIFFERENTIAL_INTO_A,
+    DIFFERENTIAL_INTO_B,
+    DIFFERENTIAL_ALIASES,
+} differential_alias_t;
+
+typedef struct differential_case_s
+{
+    differential_op_t    op;
+    differential_alias_t alias;
+    bigint_t*            a;
+    bigint_t*            b;
+    bigint_t*            c;     // Modulus for DIFFERENTIAL_POWM
+    uint32_t             small; // Shift, base, root degree or single limb operand
+} differential_case_t;
+
+const char* differential_op_name(differential_op_t op);
+
+// False on a mismatch, after describing it on stderr.
+bool        differential_check(const differential_case_t* test);
+
+#endif // DIFFERENTIAL_H
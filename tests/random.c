@@ -0,0 +1,30 @@
+#include "random.h"
+
+#include<stdlib.h>
+
+static uint32_t random_limb(void)
+{
+    if (rand() % 8 == 0) {
+        return 0xFFFFFFFFu;
+    }
+    return (uint32_t) rand() * 2654435761u ^ (uint32_t) rand();
+}
+
+bigint_t* random_number(size_t limbs)
+{
+    bigint_t* number = bigint_new();
+
+    if (number == NULL || !bigint_resize(number, limbs)) {
+        abort();
+    }
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint32_t r = random_limb();
+        while (i == 0 && r == 0) {
+            r = random_limb();
+        }
+        array_set(number, i, &r);
+    }
+
+    return number;
+}
@@ -0,0 +1,15 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+// Random operands for the unit tests, drawn from rand() so that each test's
+// srand decides them.
+
+#include<stddef.h>
+
+#include<bigint.h>
+
+// Exactly `limbs` limbs, the top one never zero, 0 for none. About one limb
+// in eight is all ones, for the carries.
+bigint_t* random_number(size_t limbs);
+
+#endif // RANDOM_H
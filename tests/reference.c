@@ -0,0 +1,339 @@
+#include "reference.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+static reference_t reference_new(size_t size)
+{
+    reference_t a = { calloc(size + 1, sizeof(uint16_t)), size };
+
+    if (a.digits == NULL) {
+        fprintf(stderr, "reference: out of memory\n");
+        abort();
+    }
+    return a;
+}
+
+static void reference_trim(reference_t* a)
+{
+    while (a->size > 0 && a->digits[a->size - 1] == 0) {
+        a->size--;
+    }
+}
+
+void reference_free(reference_t* a)
+{
+    free(a->digits);
+    a->digits = NULL;
+    a->size   = 0;
+}
+
+static reference_t reference_copy(const reference_t* a)
+{
+    reference_t r = reference_new(a->size);
+
+    for (size_t i = 0; i < a->size; i++) {
+        r.digits[i] = a->digits[i];
+    }
+    return r;
+}
+
+reference_t reference_from_u32(uint32_t value)
+{
+    reference_t r = reference_new(2);
+
+    r.digits[0] = (uint16_t) value;
+    r.digits[1] = (uint16_t) (value >> 16);
+    reference_trim(&r);
+    return r;
+}
+
+reference_t reference_from_bigint(bigint_t* number)
+{
+    size_t          n;
+    const uint32_t* limbs = bigint_limbs(number, &n);
+    reference_t     r     = reference_new(2 * n);
+
+    // Limbs are most significant first.
+    for (size_t i = 0; i < n; i++) {
+        uint32_t limb = limbs[n - 1 - i];
+        r.digits[2 * i]     = (uint16_t) limb;
+        r.digits[2 * i + 1] = (uint16_t) (limb >> 16);
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+bool reference_equals(const reference_t* a, bigint_t* number)
+{
+    reference_t b     = reference_from_bigint(number);
+    bool        equal = reference_cmp(a, &b) == 0;
+
+    reference_free(&b);
+    return equal;
+}
+
+bool reference_is_zero(const reference_t* a)
+{
+    return a->size == 0;
+}
+
+size_t reference_bitlen(const reference_t* a)
+{
+    size_t bits = 16 * a->size;
+
+    while (bits > 0 && reference_bit(a, bits - 1) == 0) {
+        bits--;
+    }
+    return bits;
+}
+
+unsigned reference_bit(const reference_t* a, size_t bit)
+{
+    if (bit / 16 >= a->size) {
+        return 0;
+    }
+    return (a->digits[bit / 16] >> (bit % 16)) & 1;
+}
+
+int reference_cmp(const reference_t* a, const reference_t* b)
+{
+    if (a->size != b->size) {
+        return a->size < b->size ? -1 : 1;
+    }
+
+    for (size_t i = a->size; i > 0; i--) {
+        if (a->digits[i - 1] != b->digits[i - 1]) {
+            return a->digits[i - 1] < b->digits[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static uint16_t reference_digit(const reference_t* a, size_t i)
+{
+    return i < a->size ? a->digits[i] : 0;
+}
+
+reference_t reference_add(const reference_t* a, const reference_t* b)
+{
+    size_t      n     = a->size > b->size ? a->size : b->size;
+    reference_t r     = reference_new(n + 1);
+    uint32_t    carry = 0;
+
+    for (size_t i = 0; i <= n; i++) {
+        uint32_t sum = (uint32_t) reference_digit(a, i) + reference_digit(b, i) + carry;
+        r.digits[i] = (uint16_t) sum;
+        carry       = sum >> 16;
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+reference_t reference_sub(const reference_t* a, const reference_t* b)
+{
+    reference_t r      = reference_new(a->size);
+    uint32_t    borrow = 0;
+
+    for (size_t i = 0; i < a->size; i++) {
+        uint32_t x = (uint32_t) a->digits[i] + 0x10000 - reference_digit(b, i) - borrow;
+        r.digits[i] = (uint16_t) x;
+        borrow      = x < 0x10000;
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+reference_t reference_mul(const reference_t* a, const reference_t* b)
+{
+    reference_t r = reference_new(a->size + b->size);
+
+    for (size_t i = 0; i < a->size; i++) {
+        uint32_t carry = 0;
+
+        for (size_t j = 0; j < b->size; j++) {
+            uint32_t t = (uint32_t) a->digits[i] * b->digits[j] + r.digits[i + j] + carry;
+            r.digits[i + j] = (uint16_t) t;
+            carry           = t >> 16;
+        }
+        r.digits[i + b->size] = (uint16_t) carry;
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+reference_t reference_shl(const reference_t* a, size_t bits)
+{
+    size_t      total = reference_bitlen(a) + bits;
+    reference_t r     = reference_new(total / 16 + 1);
+
+    for (size_t i = bits; i < total; i++) {
+        r.digits[i / 16] |= (uint16_t) (reference_bit(a, i - bits) << (i % 16));
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+reference_t reference_shr(const reference_t* a, size_t bits)
+{
+    size_t      total = reference_bitlen(a);
+    size_t      left  = total > bits ? total - bits : 0;
+    reference_t r     = reference_new(left / 16 + 1);
+
+    for (size_t i = 0; i < left; i++) {
+        r.digits[i / 16] |= (uint16_t) (reference_bit(a, i + bits) << (i % 16));
+    }
+
+    reference_trim(&r);
+    return r;
+}
+
+void reference_divmod(reference_t* q, reference_t* r, const reference_t* a, const reference_t* d)
+{
+    size_t      bits      = reference_bitlen(a);
+    reference_t quotient  = reference_new(a->size);
+    reference_t remainder = reference_new(0);
+
+    // Bring down one bit of a at a time, subtracting d whenever it fits.
+    for (size_t i = bits; i > 0; i--) {
+        reference_t shifted = reference_shl(&remainder, 1);
+
+        if (reference_bit(a, i - 1)) {
+            if (shifted.size == 0) {
+                reference_free(&shifted);
+                shifted = reference_from_u32(1);
+            } else {
+                shifted.digits[0] |= 1;
+            }
+        }
+
+        reference_free(&remainder);
+        remainder = shifted;
+
+        if (reference_cmp(&remainder, d) >= 0) {
+            reference_t less = reference_sub(&remainder, d);
+            reference_free(&remainder);
+            remainder = less;
+
+            quotient.digits[(i - 1) / 16] |= (uint16_t) (1u << ((i - 1) % 16));
+        }
+    }
+
+    reference_trim(&quotient);
+
+    if (q != NULL) {
+        *q = quotient;
+    } else {
+        reference_free(&quotient);
+    }
+
+    if (r != NULL) {
+        *r = remainder;
+    } else {
+        reference_free(&remainder);
+    }
+}
+
+reference_t reference_pow_u32(const reference_t* a, uint32_t exponent)
+{
+    reference_t r = reference_from_u32(1);
+
+    for (uint32_t i = 0; i < exponent; i++) {
+        reference_t next = reference_mul(&r, a);
+        reference_free(&r);
+        r = next;
+    }
+    return r;
+}
+
+reference_t reference_powm(const reference_t* base, const reference_t* exponent, const reference_t* modulus)
+{
+    reference_t one = reference_from_u32(1);
+    reference_t r;
+    reference_t b;
+
+    reference_divmod(NULL, &r, &one, modulus);
+    reference_divmod(NULL, &b, base, modulus);
+    reference_free(&one);
+
+    for (size_t i = reference_bitlen(exponent); i > 0; i--) {
+        reference_t square = reference_mul(&r, &r);
+        reference_free(&r);
+        reference_divmod(NULL, &r, &square, modulus);
+        reference_free(&square);
+
+        if (reference_bit(exponent, i - 1)) {
+            reference_t product = reference_mul(&r, &b);
+            reference_free(&r);
+            reference_divmod(NULL, &r, &product, modulus);
+            reference_free(&product);
+        }
+    }
+
+    reference_free(&b);
+    return r;
+}
+
+reference_t reference_gcd(const reference_t* a, const reference_t* b)
+{
+    reference_t u = reference_copy(a);
+    reference_t v = reference_copy(b);
+
+    while (!reference_is_zero(&v)) {
+        reference_t w;
+        reference_divmod(NULL, &w, &u, &v);
+        reference_free(&u);
+        u = v;
+        v = w;
+    }
+
+    reference_free(&v);
+    return u;
+}
+
+char* reference_to_string(const reference_t* a, unsigned base)
+{
+    static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    // At least one digit per 16 bit digit and base 2 uses 16 of them.
+    size_t      capacity = 16 * a->size + 2;
+    char*       out      = malloc(capacity);
+    size_t      count    = 0;
+    reference_t t        = reference_copy(a);
+
+    if (out == NULL) {
+        fprintf(stderr, "reference: out of memory\n");
+        abort();
+    }
+
+    // Peel off the lowest digit with short division, most significant last.
+    do {
+        uint32_t rem = 0;
+
+        for (size_t i = t.size; i > 0; i--) {
+            uint32_t x = (rem << 16) | t.digits[i - 1];
+            t.digits[i - 1] = (uint16_t) (x / base);
+            rem             = x % base;
+        }
+
+        out[count++] = digits[rem];
+        reference_trim(&t);
+    } while (t.size > 0);
+
+    reference_free(&t);
+
+    for (size_t i = 0; i < count / 2; i++) {
+        char c = out[i];
+        out[i]             = out[count - 1 - i];
+        out[count - 1 - i] = c;
+    }
+
+    out[count] = '\0';
+    return out;
+}
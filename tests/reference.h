@@ -0,0 +1,49 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+// Slow, plainly written arithmetic to check the library against. Nothing in
+// here shares code with it: numbers are little endian vectors of 16 bit
+// digits so every carry and product fits a uint32_t, division goes one bit
+// at a time, and so on. Every function returns a new number, to be released
+// with reference_free. Running out of memory aborts.
+
+#include<stdbool.h>
+#include<stddef.h>
+#include<stdint.h>
+
+#include<bigint.h>
+
+typedef struct reference_s
+{
+    uint16_t* digits; // Least significant first
+    size_t    size;   // Without leading zeroes, so 0 for zero
+} reference_t;
+
+void        reference_free(reference_t* a);
+
+reference_t reference_from_u32(uint32_t value);
+reference_t reference_from_bigint(bigint_t* number);
+bool        reference_equals(const reference_t* a, bigint_t* number);
+
+bool        reference_is_zero(const reference_t* a);
+size_t      reference_bitlen(const reference_t* a);
+unsigned    reference_bit(const reference_t* a, size_t bit);
+int         reference_cmp(const reference_t* a, const reference_t* b);
+
+reference_t reference_add(const reference_t* a, const reference_t* b);
+reference_t reference_sub(const reference_t* a, const reference_t* b); // a >= b
+reference_t reference_mul(const reference_t* a, const reference_t* b);
+reference_t reference_shl(const reference_t* a, size_t bits);
+reference_t reference_shr(const reference_t* a, size_t bits);
+
+// Binary long division, d must not be zero. q or r may be NULL.
+void        reference_divmod(reference_t* q, reference_t* r, const reference_t* a, const reference_t* d);
+
+reference_t reference_pow_u32(const reference_t* a, uint32_t exponent);
+reference_t reference_powm(const reference_t* base, const reference_t* exponent, const reference_t* modulus);
+reference_t reference_gcd(const reference_t* a, const reference_t* b);
+
+// Digits in base 2 to 36, uppercase, to be freed by the caller.
+char*       reference_to_string(const reference_t* a, unsigned base);
+
+#endif // REFERENCE_H